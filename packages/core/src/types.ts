@@ -18,9 +18,15 @@ export interface Source {
   password?: string;      // Xtream only
   epg_url?: string;       // Auto-detected or manual override
   auto_load_epg?: boolean; // Auto-fetch EPG from source (default: true for xtream)
+  epg_mode?: EpgMode;      // Xtream only (default: 'full')
+  fetch_by_category?: boolean; // Xtream only: fetch catalogs per category in parallel
   enabled: boolean;
 }
 
+// 'full': download the whole XMLTV guide on sync
+// 'on_demand': skip XMLTV, fetch short EPG for channels as they are shown
+export type EpgMode = 'full' | 'on_demand';
+
 export interface XtreamSource extends Source {
   type: 'xtream';
   username: string;
@@ -58,6 +64,7 @@ export interface Channel {
   // Optional metadata
   tv_archive?: boolean;   // Has catchup/timeshift
   is_adult?: boolean;
+  m3u_attributes?: Record<string, string>; // Extra EXTINF attributes (tvg-chno, catchup, tvg-shift, ...)
 }
 
 // =============================================================================
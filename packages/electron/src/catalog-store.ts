@@ -0,0 +1,281 @@
+/**
+ * SQLite catalog store (optional backend for browsing movies, series and channels)
+ *
+ * A read-optimised copy of the renderer's catalog tables in
+ * userData/catalog.sqlite. The renderer stays the source of truth: after a
+ * sync it pushes each source's rows here (see the UI's catalog-mirror.ts),
+ * tagged with a sync id, and rows the sync didn't touch are dropped.
+ *
+ * Rows are stored as JSON next to the indexed columns. Browse queries use
+ * keyset pagination over (name, rowid) / (added, rowid) indexes; category
+ * membership lives in item_categories, whose primary key is ordered by name
+ * so a category page is a single index range. Name search uses an FTS5 index
+ * kept in step by triggers.
+ */
+
+import { app } from 'electron';
+import * as fs from 'fs';
+import * as path from 'path';
+import { DatabaseSync, type StatementSync } from 'node:sqlite';
+
+export type CatalogKind = 'movie' | 'series' | 'channel';
+
+export interface CatalogQuery {
+  kind: CatalogKind;
+  categoryId?: string;
+  search?: string;              // Every word must prefix-match a word of the name
+  order?: 'name' | 'added';     // name ascending (default) or newest first
+  limit: number;
+  after?: CatalogCursor;        // Continue after the last row of the previous page
+}
+
+export interface CatalogCursor {
+  key: string | number;  // name or added of the last row
+  rowid: number;
+}
+
+export interface CatalogPage {
+  items: unknown[];
+  next?: CatalogCursor;  // Undefined on the last page
+}
+
+export interface CatalogStats {
+  movies: number;
+  series: number;
+  channels: number;
+  size: number;  // Database file size in bytes
+}
+
+// Primary key field of each kind's rows (as in the renderer's tables)
+const ID_FIELDS: Record<CatalogKind, string> = { movie: 'stream_id', series: 'series_id', channel: 'stream_id' };
+
+// Row fields stored as Date in the renderer (JSON turns them into strings)
+const DATE_FIELDS = new Set(['added', 'match_attempted']);
+
+const MAX_PAGE_SIZE = 5000;
+
+const SCHEMA = `
+  CREATE TABLE IF NOT EXISTS items (
+    rowid INTEGER PRIMARY KEY,
+    kind TEXT NOT NULL,
+    id TEXT NOT NULL,
+    source_id TEXT NOT NULL,
+    name TEXT NOT NULL COLLATE NOCASE,
+    added INTEGER NOT NULL DEFAULT 0,
+    data TEXT NOT NULL,
+    synced INTEGER NOT NULL,
+    UNIQUE (kind, id)
+  );
+  CREATE INDEX IF NOT EXISTS items_kind_name ON items (kind, name);
+  CREATE INDEX IF NOT EXISTS items_kind_added ON items (kind, added);
+  CREATE INDEX IF NOT EXISTS items_source ON items (source_id, kind, synced);
+
+  CREATE TABLE IF NOT EXISTS item_categories (
+    kind TEXT NOT NULL,
+    category_id TEXT NOT NULL,
+    name TEXT NOT NULL COLLATE NOCASE,
+    item INTEGER NOT NULL,
+    PRIMARY KEY (kind, category_id, name, item)
+  ) WITHOUT ROWID;
+  CREATE INDEX IF NOT EXISTS item_categories_item ON item_categories (item);
+
+  CREATE VIRTUAL TABLE IF NOT EXISTS items_fts USING fts5(
+    name, content='items', content_rowid='rowid', tokenize='unicode61 remove_diacritics 2'
+  );
+
+  CREATE TRIGGER IF NOT EXISTS items_ai AFTER INSERT ON items BEGIN
+    INSERT INTO items_fts (rowid, name) VALUES (new.rowid, new.name);
+  END;
+  CREATE TRIGGER IF NOT EXISTS items_ad AFTER DELETE ON items BEGIN
+    INSERT INTO items_fts (items_fts, rowid, name) VALUES ('delete', old.rowid, old.name);
+    DELETE FROM item_categories WHERE item = old.rowid;
+  END;
+  CREATE TRIGGER IF NOT EXISTS items_au AFTER UPDATE OF name ON items BEGIN
+    INSERT INTO items_fts (items_fts, rowid, name) VALUES ('delete', old.rowid, old.name);
+    INSERT INTO items_fts (rowid, name) VALUES (new.rowid, new.name);
+  END;
+`;
+
+let db: DatabaseSync | null = null;
+const statements = new Map<string, StatementSync>();
+
+function dbPath(): string {
+  return path.join(app.getPath('userData'), 'catalog.sqlite');
+}
+
+function open(): DatabaseSync {
+  if (db) return db;
+  db = new DatabaseSync(dbPath());
+  db.exec('PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL;');
+  db.exec(SCHEMA);
+  return db;
+}
+
+// Prepared statements are cached by their SQL
+function stmt(sql: string): StatementSync {
+  let statement = statements.get(sql);
+  if (!statement) {
+    statement = open().prepare(sql);
+    statements.set(sql, statement);
+  }
+  return statement;
+}
+
+function parseRow(data: string): unknown {
+  return JSON.parse(data, (key, value) =>
+    DATE_FIELDS.has(key) && typeof value === 'string' ? new Date(value) : value
+  );
+}
+
+function addedMs(row: Record<string, unknown>): number {
+  const added = row.added;
+  if (added instanceof Date) return added.getTime();
+  if (typeof added === 'string' || typeof added === 'number') return new Date(added).getTime() || 0;
+  return 0;
+}
+
+// FTS5 query: each word as a quoted prefix term (implicit AND)
+function ftsQuery(search: string): string | null {
+  const words = search.toLowerCase().split(/[^\p{L}\p{N}]+/u).filter(Boolean);
+  if (words.length === 0) return null;
+  return words.map((word) => `"${word}"*`).join(' ');
+}
+
+/**
+ * One page of catalog rows
+ */
+export function queryCatalog(query: CatalogQuery): CatalogPage {
+  const limit = Math.max(1, Math.min(query.limit, MAX_PAGE_SIZE));
+  const match = query.search ? ftsQuery(query.search) : null;
+  const byAdded = query.order === 'added';
+  const params: (string | number)[] = [];
+  let sql: string;
+
+  if (query.categoryId && !match && !byAdded) {
+    // Category browse: a range of the item_categories primary key, already in name order
+    sql = `SELECT i.rowid AS rowid, i.name AS name, i.added AS added, i.data AS data
+      FROM item_categories c JOIN items i ON i.rowid = c.item
+      WHERE c.kind = ? AND c.category_id = ?`;
+    params.push(query.kind, query.categoryId);
+    if (query.after) {
+      sql += ' AND (c.name, c.item) > (?, ?)';
+      params.push(query.after.key, query.after.rowid);
+    }
+    sql += ' ORDER BY c.name, c.item LIMIT ?';
+  } else {
+    sql = 'SELECT rowid, name, added, data FROM items WHERE kind = ?';
+    params.push(query.kind);
+    if (query.categoryId) {
+      sql += ' AND rowid IN (SELECT item FROM item_categories WHERE kind = ? AND category_id = ?)';
+      params.push(query.kind, query.categoryId);
+    }
+    if (match) {
+      sql += ' AND rowid IN (SELECT rowid FROM items_fts WHERE items_fts MATCH ?)';
+      params.push(match);
+    }
+    if (query.after) {
+      sql += byAdded ? ' AND (added, rowid) < (?, ?)' : ' AND (name, rowid) > (?, ?)';
+      params.push(query.after.key, query.after.rowid);
+    }
+    sql += byAdded ? ' ORDER BY added DESC, rowid DESC LIMIT ?' : ' ORDER BY name, rowid LIMIT ?';
+  }
+  params.push(limit);
+
+  const rows = stmt(sql).all(...params) as { rowid: number; name: string; added: number; data: string }[];
+  const last = rows[rows.length - 1];
+  return {
+    items: rows.map((row) => parseRow(row.data)),
+    next: rows.length === limit && last
+      ? { key: byAdded ? last.added : last.name, rowid: last.rowid }
+      : undefined,
+  };
+}
+
+/**
+ * Categories of a kind that contain at least one item
+ */
+export function getNonEmptyCategories(kind: CatalogKind): string[] {
+  const rows = stmt('SELECT DISTINCT category_id FROM item_categories WHERE kind = ?').all(kind) as { category_id: string }[];
+  return rows.map((row) => row.category_id);
+}
+
+/**
+ * Store a batch of a source's rows. `syncId` identifies the sync pushing
+ * them; finishCatalogSource() drops the rows it didn't touch.
+ */
+export function writeCatalogItems(kind: CatalogKind, sourceId: string, syncId: number, rows: Record<string, unknown>[]): void {
+  const database = open();
+  const existing = stmt('SELECT rowid, data FROM items WHERE kind = ? AND id = ?');
+  const touch = stmt('UPDATE items SET synced = ? WHERE rowid = ?');
+  const upsert = stmt(`INSERT INTO items (kind, id, source_id, name, added, data, synced) VALUES (?, ?, ?, ?, ?, ?, ?)
+    ON CONFLICT (kind, id) DO UPDATE SET source_id = excluded.source_id, name = excluded.name,
+      added = excluded.added, data = excluded.data, synced = excluded.synced
+    RETURNING rowid`);
+  const clearCategories = stmt('DELETE FROM item_categories WHERE item = ?');
+  const addCategory = stmt('INSERT OR IGNORE INTO item_categories (kind, category_id, name, item) VALUES (?, ?, ?, ?)');
+
+  database.exec('BEGIN');
+  try {
+    for (const row of rows) {
+      const id = String(row[ID_FIELDS[kind]]);
+      const data = JSON.stringify(row);
+      const current = existing.get(kind, id) as { rowid: number; data: string } | undefined;
+      if (current && current.data === data) {
+        touch.run(syncId, current.rowid);
+        continue;
+      }
+
+      const name = String(row.name ?? '');
+      const { rowid } = upsert.get(kind, id, sourceId, name, addedMs(row), data, syncId) as { rowid: number };
+      clearCategories.run(rowid);
+      for (const categoryId of (row.category_ids as string[] | undefined) ?? []) {
+        addCategory.run(kind, categoryId, name, rowid);
+      }
+    }
+    database.exec('COMMIT');
+  } catch (error) {
+    database.exec('ROLLBACK');
+    throw error;
+  }
+}
+
+/**
+ * Drop a source's rows of a kind that weren't written by sync `syncId`.
+ * Returns the number of rows removed.
+ */
+export function finishCatalogSource(kind: CatalogKind, sourceId: string, syncId: number): number {
+  const result = stmt('DELETE FROM items WHERE source_id = ? AND kind = ? AND synced <> ?').run(sourceId, kind, syncId);
+  return Number(result.changes);
+}
+
+/**
+ * Remove every row of a source (source deleted)
+ */
+export function deleteCatalogSource(sourceId: string): void {
+  stmt('DELETE FROM items WHERE source_id = ?').run(sourceId);
+}
+
+export function getCatalogStats(): CatalogStats {
+  const counts = { movie: 0, series: 0, channel: 0 };
+  const rows = stmt('SELECT kind, COUNT(*) AS count FROM items GROUP BY kind').all() as { kind: CatalogKind; count: number }[];
+  for (const row of rows) counts[row.kind] = Number(row.count);
+
+  let size = 0;
+  for (const file of [dbPath(), `${dbPath()}-wal`]) {
+    try {
+      size += fs.statSync(file).size;
+    } catch {
+      // No WAL file yet
+    }
+  }
+  return { movies: counts.movie, series: counts.series, channels: counts.channel, size };
+}
+
+/**
+ * Close the database (call before quitting)
+ */
+export function closeCatalogStore(): void {
+  statements.clear();
+  db?.close();
+  db = null;
+}
@@ -0,0 +1,310 @@
+/**
+ * Fetch scheduler for proxied requests
+ *
+ * All renderer-initiated network requests go through here so that bursts
+ * (catalog fetches, episode syncs and guide downloads running together) stay
+ * polite towards IPTV panels, which tend to rate-limit or drop connections:
+ *
+ * - at most MAX_PER_HOST requests in flight per host, the rest queue FIFO
+ *   (Chromium's network stack behind net.fetch pools keep-alive connections
+ *   per host, so staying under its pool size means connections get reused)
+ * - a timeout until response headers arrive, then an idle timeout between
+ *   body chunks, so a stalled body or consumer can't pin a host slot
+ * - retries with exponential backoff and full jitter for 429, 5xx and
+ *   network errors (connection resets, timeouts); Retry-After is honoured
+ * - concurrent identical GET requests are coalesced into one network call
+ *   whose result is shared by every caller
+ * - per-host latency / error / coalescing statistics
+ */
+
+import { net as electronNet } from 'electron';
+
+const MAX_PER_HOST = 4;
+const HEADERS_TIMEOUT_MS = 30_000;
+// Longest gap between body chunks (the download stalled, or the reader
+// stopped pulling) before the request is aborted
+export const BODY_IDLE_TIMEOUT_MS = 30_000;
+const MAX_RETRIES = 3;
+const BACKOFF_BASE_MS = 500;
+const BACKOFF_MAX_MS = 30_000;
+
+export interface HostStats {
+  host: string;
+  requests: number;       // Completed requests (after retries)
+  failures: number;       // Requests that failed for good
+  retries: number;
+  timeouts: number;
+  active: number;
+  queued: number;
+  avgLatencyMs: number;   // Time to response headers
+  maxLatencyMs: number;
+  coalescedHits: number;   // Requests served by another caller's in-flight request
+  coalescedMisses: number; // Coalescable requests that went to the network
+  lastStatus?: number;
+  lastError?: string;
+}
+
+interface HostState {
+  active: number;
+  waiters: (() => void)[];
+  stats: HostStats;
+  latencyTotal: number;
+  latencyCount: number;
+}
+
+const hosts = new Map<string, HostState>();
+// Coalescable GET requests currently in flight, by coalescing key
+const inFlight = new Map<string, Promise<unknown>>();
+
+function getHost(url: string): HostState {
+  let host: string;
+  try {
+    host = new URL(url).host;
+  } catch {
+    host = 'invalid';
+  }
+  let state = hosts.get(host);
+  if (!state) {
+    state = {
+      active: 0,
+      waiters: [],
+      latencyTotal: 0,
+      latencyCount: 0,
+      stats: { host, requests: 0, failures: 0, retries: 0, timeouts: 0, active: 0, queued: 0, avgLatencyMs: 0, maxLatencyMs: 0,
+        coalescedHits: 0, coalescedMisses: 0,
+      },
+    };
+    hosts.set(host, state);
+  }
+  return state;
+}
+
+async function acquire(state: HostState): Promise<void> {
+  if (state.active >= MAX_PER_HOST) {
+    await new Promise<void>((resolve) => state.waiters.push(resolve));
+  }
+  state.active++;
+}
+
+function release(state: HostState): void {
+  state.active--;
+  state.waiters.shift()?.();
+}
+
+function isRetryableStatus(status: number): boolean {
+  return status === 429 || (status >= 500 && status !== 501 && status !== 505);
+}
+
+// Chromium net errors (net.fetch) that mean the connection failed or dropped
+const RETRYABLE_NET_ERROR = /net::ERR_(CONNECTION_\w+|TIMED_OUT|NETWORK_\w+|INTERNET_DISCONNECTED|NAME_NOT_RESOLVED|ADDRESS_UNREACHABLE|EMPTY_RESPONSE|SOCKET_\w+|HTTP2_\w+|QUIC_\w+|CONTENT_LENGTH_MISMATCH|INCOMPLETE_CHUNKED_ENCODING)\b/;
+// System / undici error codes (Node fetch: TypeError 'fetch failed' or
+// 'terminated' with one of these on its cause)
+const RETRYABLE_ERROR_CODES = new Set(['ECONNRESET', 'ECONNREFUSED', 'ETIMEDOUT', 'ENOTFOUND', 'EAI_AGAIN', 'EPIPE']);
+
+// Failures worth retrying (refused / dropped connections), as opposed to
+// errors thrown by the caller's parsing or bugs such as an invalid header
+function isNetworkError(error: unknown): boolean {
+  let e = error;
+  for (let depth = 0; depth < 4 && e instanceof Error; depth++) {
+    if (RETRYABLE_NET_ERROR.test(e.message)) return true;
+    const code = (e as { code?: unknown }).code;
+    if (typeof code === 'string' && (RETRYABLE_ERROR_CODES.has(code) || code.startsWith('UND_ERR_'))) return true;
+    e = e.cause;
+  }
+  return false;
+}
+
+function delay(ms: number): Promise<void> {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+function backoffMs(attempt: number, retryAfter: string | null): number {
+  // Retry-After: seconds or an HTTP date
+  if (retryAfter) {
+    const seconds = Number(retryAfter);
+    const ms = Number.isFinite(seconds) ? seconds * 1000 : Date.parse(retryAfter) - Date.now();
+    if (ms > 0) return Math.min(ms, BACKOFF_MAX_MS);
+  }
+  // Full jitter: random delay up to the exponential cap
+  return Math.random() * Math.min(BACKOFF_BASE_MS * 2 ** attempt, BACKOFF_MAX_MS);
+}
+
+class TimeoutError extends Error {
+  constructor() {
+    super('Request timed out');
+    this.name = 'TimeoutError';
+  }
+}
+
+// Statuses that can't carry a body (the Response constructor rejects one)
+const NULL_BODY_STATUSES = new Set([101, 204, 205, 304]);
+
+/**
+ * Wrap a response so its body errors with a TimeoutError (and `abort` runs)
+ * when no chunk passes for BODY_IDLE_TIMEOUT_MS. Chunks only pass when the
+ * reader pulls, so a reader that stops consuming times out too. `stop`
+ * disarms the timer once the reader is done.
+ */
+function withIdleTimeout(response: Response, abort: (reason: Error) => void): { response: Response; stop: () => void } {
+  if (!response.body || NULL_BODY_STATUSES.has(response.status)) {
+    return { response, stop: () => {} };
+  }
+
+  let timer: ReturnType<typeof setTimeout> | undefined;
+  let output: TransformStreamDefaultController<Uint8Array> | undefined;
+  const stop = () => clearTimeout(timer);
+  const arm = () => {
+    stop();
+    timer = setTimeout(() => {
+      const reason = new TimeoutError();
+      output?.error(reason);
+      abort(reason);
+    }, BODY_IDLE_TIMEOUT_MS);
+  };
+
+  const body = response.body.pipeThrough(new TransformStream<Uint8Array, Uint8Array>({
+    start(controller) {
+      output = controller;
+      arm();
+    },
+    transform(chunk, controller) {
+      arm();
+      controller.enqueue(chunk);
+    },
+    flush: stop,
+  }));
+  const wrapped = new Response(body, {
+    status: response.status,
+    statusText: response.statusText,
+    headers: response.headers,
+  });
+  return { response: wrapped, stop };
+}
+
+/**
+ * Fetch through the scheduler. `read` consumes the response while the host
+ * slot is held (so a streaming body still counts against the limit) and
+ * must keep pulling: a body idle for BODY_IDLE_TIMEOUT_MS is aborted. It is
+ * re-run if the connection drops or stalls mid-body, so it must not have side
+ * effects before it succeeds. Only GET / HEAD requests are retried.
+ *
+ * GET requests with a `shareAs` tag are coalesced: a request with the same
+ * tag, URL and headers as one already in flight waits for that one and gets
+ * the same result object (callers must not mutate it). The tag identifies
+ * what `read` produces, so different readers never share a result.
+ */
+export function scheduledFetch<T>(
+  url: string,
+  init: RequestInit,
+  read: (response: Response) => Promise<T>,
+  shareAs?: string
+): Promise<T> {
+  const method = (init.method || 'GET').toUpperCase();
+  if (!shareAs || method !== 'GET' || init.body) {
+    return runFetch(url, init, read);
+  }
+
+  const state = getHost(url);
+  const key = `${shareAs} ${url} ${JSON.stringify(init.headers ?? {})}`;
+  const existing = inFlight.get(key);
+  if (existing) {
+    state.stats.coalescedHits++;
+    return existing as Promise<T>;
+  }
+
+  state.stats.coalescedMisses++;
+  const request = runFetch(url, init, read).finally(() => inFlight.delete(key));
+  inFlight.set(key, request);
+  return request;
+}
+
+async function runFetch<T>(
+  url: string,
+  init: RequestInit,
+  read: (response: Response) => Promise<T>
+): Promise<T> {
+  const state = getHost(url);
+  const method = (init.method || 'GET').toUpperCase();
+  const retries = method === 'GET' || method === 'HEAD' ? MAX_RETRIES : 0;
+
+  state.stats.queued++;
+  await acquire(state);
+  state.stats.queued--;
+  state.stats.active = state.active;
+
+  try {
+    for (let attempt = 0; ; attempt++) {
+      const controller = new AbortController();
+      const timer = setTimeout(() => controller.abort(new TimeoutError()), HEADERS_TIMEOUT_MS);
+      const started = Date.now();
+      let response: Response;
+
+      try {
+        response = await electronNet.fetch(url, { ...init, signal: controller.signal });
+      } catch (error) {
+        clearTimeout(timer);
+        const timedOut = controller.signal.aborted;
+        if (timedOut) state.stats.timeouts++;
+        const message = timedOut ? 'Request timed out' : error instanceof Error ? error.message : 'Fetch failed';
+        if (attempt < retries && (timedOut || isNetworkError(error))) {
+          state.stats.retries++;
+          await delay(backoffMs(attempt, null));
+          continue;
+        }
+        state.stats.failures++;
+        state.stats.lastError = message;
+        throw timedOut ? new TimeoutError() : error;
+      }
+      clearTimeout(timer);
+
+      const latency = Date.now() - started;
+      state.latencyTotal += latency;
+      state.latencyCount++;
+      state.stats.avgLatencyMs = Math.round(state.latencyTotal / state.latencyCount);
+      state.stats.maxLatencyMs = Math.max(state.stats.maxLatencyMs, latency);
+      state.stats.lastStatus = response.status;
+
+      if (isRetryableStatus(response.status) && attempt < retries) {
+        await response.body?.cancel().catch(() => {});
+        state.stats.retries++;
+        await delay(backoffMs(attempt, response.headers.get('retry-after')));
+        continue;
+      }
+
+      const body = withIdleTimeout(response, (reason) => controller.abort(reason));
+      try {
+        const result = await read(body.response);
+        state.stats.requests++;
+        if (!response.ok) {
+          state.stats.failures++;
+          state.stats.lastError = `HTTP ${response.status}`;
+        }
+        return result;
+      } catch (error) {
+        // Connection dropped or stalled while reading the body
+        const timedOut = controller.signal.aborted;
+        if (timedOut) state.stats.timeouts++;
+        if (attempt < retries && (timedOut || isNetworkError(error))) {
+          state.stats.retries++;
+          await delay(backoffMs(attempt, null));
+          continue;
+        }
+        state.stats.failures++;
+        state.stats.lastError = timedOut ? 'Body stalled' : error instanceof Error ? error.message : 'Read failed';
+        throw timedOut ? new TimeoutError() : error;
+      } finally {
+        body.stop();
+      }
+    }
+  } finally {
+    release(state);
+    state.stats.active = state.active;
+  }
+}
+
+/**
+ * Per-host request statistics since startup
+ */
+export function getFetchStats(): HostStats[] {
+  return [...hosts.values()].map((state) => ({ ...state.stats }));
+}
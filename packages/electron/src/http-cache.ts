@@ -0,0 +1,368 @@
+/**
+ * On-disk HTTP cache for proxied GET requests
+ *
+ * Bodies are stored under userData/http-cache together with their ETag /
+ * Last-Modified validators. Each URL class has a TTL: within it a stored
+ * body is served without touching the network; after it the request is
+ * revalidated with If-None-Match / If-Modified-Since and a 304 is served
+ * from disk. Responses without validators are only stored for classes with
+ * a TTL, since they could never be revalidated.
+ *
+ * The index only records hashed keys - request URLs (which carry Xtream
+ * credentials) are never written to disk. Total size is capped, evicting
+ * the least recently used entries.
+ */
+
+import { app } from 'electron';
+import * as fs from 'fs';
+import * as path from 'path';
+import { createHash, randomUUID } from 'crypto';
+import { Readable } from 'stream';
+import { scheduledFetch } from './fetch-scheduler.js';
+
+const CACHE_MAX_BYTES = 1024 * 1024 * 1024;
+// Larger bodies are not stored (a single guide shouldn't flush everything else)
+const CACHE_MAX_ENTRY_BYTES = CACHE_MAX_BYTES / 4;
+// Delay before index changes are written
+const INDEX_SAVE_DELAY_MS = 2000;
+
+const HOUR_MS = 60 * 60 * 1000;
+
+// Headers that describe the transfer rather than the (decoded) stored body
+const SKIPPED_HEADERS = new Set(['content-encoding', 'content-length', 'transfer-encoding', 'connection', 'keep-alive']);
+
+interface CacheEntry {
+  status: number;
+  statusText: string;
+  headers: Record<string, string>;
+  etag?: string;
+  lastModified?: string;
+  size: number;
+  storedAt: number;  // Last download or successful revalidation
+  lastUsed: number;
+}
+
+export interface HttpCacheStats {
+  hits: number;         // Served from disk without a request
+  revalidated: number;  // 304 - served from disk after a conditional request
+  misses: number;       // Body downloaded
+  bytesFromCache: number;
+  entries: number;
+  size: number;
+}
+
+let cacheDir: string | null = null;
+let index: Map<string, CacheEntry> | null = null;
+let saveTimer: ReturnType<typeof setTimeout> | null = null;
+// Entries with a conditional request in flight (key -> request count), kept
+// out of eviction so a 304 still has a body to serve
+const revalidating = new Map<string, number>();
+const stats = { hits: 0, revalidated: 0, misses: 0, bytesFromCache: 0 };
+
+/**
+ * Freshness lifetime for a URL, or null if it must not be cached.
+ * 0 means every use is revalidated.
+ */
+function ttlFor(url: string): number | null {
+  let parsed: URL;
+  try {
+    parsed = new URL(url);
+  } catch {
+    return null;
+  }
+
+  // TMDB daily exports are dated - a file never changes once published
+  if (parsed.hostname === 'files.tmdb.org') return 7 * 24 * HOUR_MS;
+  // TMDB cache repository, rebuilt daily
+  if (parsed.hostname === 'raw.githubusercontent.com') return 6 * HOUR_MS;
+
+  if (parsed.pathname.endsWith('/player_api.php')) {
+    const action = parsed.searchParams.get('action');
+    // Account info and short EPG change constantly
+    if (!action || action === 'get_short_epg') return null;
+  }
+
+  // Playlists, catalogs and guides: the sync schedule decides when to refresh,
+  // so these are always revalidated
+  return 0;
+}
+
+function getCacheDir(): string {
+  if (!cacheDir) {
+    cacheDir = path.join(app.getPath('userData'), 'http-cache');
+    fs.mkdirSync(cacheDir, { recursive: true });
+  }
+  return cacheDir;
+}
+
+function bodyPath(key: string): string {
+  return path.join(getCacheDir(), key);
+}
+
+function loadIndex(): Map<string, CacheEntry> {
+  if (index) return index;
+  index = new Map();
+  try {
+    const raw = JSON.parse(fs.readFileSync(path.join(getCacheDir(), 'index.json'), 'utf-8')) as Record<string, CacheEntry>;
+    for (const [key, entry] of Object.entries(raw)) {
+      if (fs.existsSync(bodyPath(key))) index.set(key, entry);
+    }
+  } catch {
+    // Missing or corrupt index - start empty (orphaned bodies are overwritten or evicted)
+  }
+  return index;
+}
+
+function scheduleSave(): void {
+  if (saveTimer) return;
+  saveTimer = setTimeout(() => {
+    saveTimer = null;
+    saveIndex();
+  }, INDEX_SAVE_DELAY_MS);
+}
+
+function saveIndex(): void {
+  if (!index) return;
+  const file = path.join(getCacheDir(), 'index.json');
+  const tmp = `${file}.${randomUUID()}.tmp`;
+  try {
+    fs.writeFileSync(tmp, JSON.stringify(Object.fromEntries(index)));
+    fs.renameSync(tmp, file);
+  } catch (error) {
+    console.warn('[HTTP Cache] Failed to save index:', error);
+  }
+}
+
+function removeEntry(key: string): void {
+  index?.delete(key);
+  fs.promises.unlink(bodyPath(key)).catch(() => {});
+}
+
+// Evict least recently used entries until `incoming` more bytes fit
+function makeRoom(incoming: number): void {
+  const entries = loadIndex();
+  let total = incoming;
+  for (const entry of entries.values()) total += entry.size;
+  if (total <= CACHE_MAX_BYTES) return;
+
+  const byAge = [...entries].sort((a, b) => a[1].lastUsed - b[1].lastUsed);
+  for (const [key, entry] of byAge) {
+    if (total <= CACHE_MAX_BYTES) break;
+    if (revalidating.has(key)) continue;
+    removeEntry(key);
+    total -= entry.size;
+  }
+}
+
+function cacheKey(url: string, headers: Record<string, string> | undefined): string {
+  return createHash('sha256').update(url).update('\n').update(JSON.stringify(headers ?? {})).digest('hex');
+}
+
+// A stored body as a Response, so readers can't tell it from a network one
+function diskResponse(key: string, entry: CacheEntry): Response {
+  entry.lastUsed = Date.now();
+  scheduleSave();
+  stats.bytesFromCache += entry.size;
+  const body = Readable.toWeb(fs.createReadStream(bodyPath(key))) as ReadableStream<Uint8Array>;
+  return new Response(body, { status: entry.status, statusText: entry.statusText, headers: entry.headers });
+}
+
+/**
+ * Pass a response body through while writing it to a temporary file. The
+ * entry is stored when the body completes; if the consumer cancels or the
+ * download fails the partial file is discarded. Disk errors only disable
+ * storing, the data still reaches the consumer.
+ */
+function storeWhileReading(key: string, response: Response): Response {
+  const reader = response.body!.getReader();
+  const tmp = `${bodyPath(key)}.${randomUUID()}.tmp`;
+  let file: fs.promises.FileHandle | null = null;
+  let size = 0;
+
+  const discard = async () => {
+    const handle = file;
+    file = null;
+    await handle?.close().catch(() => {});
+    await fs.promises.unlink(tmp).catch(() => {});
+  };
+
+  const body = new ReadableStream<Uint8Array>({
+    async start() {
+      file = await fs.promises.open(tmp, 'w').catch(() => null);
+    },
+    async pull(controller) {
+      let chunk: ReadableStreamReadResult<Uint8Array>;
+      try {
+        chunk = await reader.read();
+      } catch (error) {
+        await discard();
+        throw error;
+      }
+
+      if (chunk.done) {
+        if (file) {
+          const handle = file;
+          file = null;
+          try {
+            await handle.close();
+            commit(key, response, size, tmp);
+          } catch {
+            await fs.promises.unlink(tmp).catch(() => {});
+          }
+        }
+        controller.close();
+        return;
+      }
+
+      if (file) {
+        size += chunk.value.byteLength;
+        try {
+          if (size > CACHE_MAX_ENTRY_BYTES) throw new Error('Too large to cache');
+          await file.write(chunk.value);
+        } catch {
+          await discard();
+        }
+      }
+      controller.enqueue(chunk.value);
+    },
+    async cancel(reason) {
+      await discard();
+      await reader.cancel(reason);
+    },
+  });
+
+  return new Response(body, { status: response.status, statusText: response.statusText, headers: response.headers });
+}
+
+function commit(key: string, response: Response, size: number, tmp: string): void {
+  const headers: Record<string, string> = {};
+  for (const [name, value] of response.headers.entries()) {
+    if (!SKIPPED_HEADERS.has(name)) headers[name] = value;
+  }
+
+  // The old body (if any) is replaced by the rename, not evicted
+  loadIndex().delete(key);
+  makeRoom(size);
+  fs.renameSync(tmp, bodyPath(key));
+  const now = Date.now();
+  loadIndex().set(key, {
+    status: response.status,
+    statusText: response.statusText,
+    headers,
+    etag: headers['etag'],
+    lastModified: headers['last-modified'],
+    size,
+    storedAt: now,
+    lastUsed: now,
+  });
+  scheduleSave();
+}
+
+// Returned by a revalidation whose 304 can't be served from disk
+const NOT_CACHED = Symbol('not cached');
+
+function pin(key: string): void {
+  revalidating.set(key, (revalidating.get(key) ?? 0) + 1);
+}
+
+function unpin(key: string): void {
+  const count = (revalidating.get(key) ?? 1) - 1;
+  if (count > 0) revalidating.set(key, count);
+  else revalidating.delete(key);
+}
+
+/**
+ * Fetch through the cache and the fetch scheduler (same contract as
+ * scheduledFetch). Requests other than plain GETs of cacheable URLs go
+ * straight to the scheduler.
+ */
+export async function cachedFetch<T>(
+  url: string,
+  init: RequestInit & { headers?: Record<string, string> },
+  read: (response: Response) => Promise<T>,
+  shareAs?: string
+): Promise<T> {
+  const method = (init.method || 'GET').toUpperCase();
+  const ttl = ttlFor(url);
+  if (method !== 'GET' || init.body || ttl === null) {
+    return scheduledFetch(url, init, read, shareAs);
+  }
+
+  const key = cacheKey(url, init.headers);
+  const cached = loadIndex().get(key);
+
+  if (cached && Date.now() - cached.storedAt < ttl) {
+    stats.hits++;
+    return read(diskResponse(key, cached));
+  }
+
+  // Store a downloaded body (or pass it through if it can't be cached)
+  const download = (response: Response): Promise<T> => {
+    stats.misses++;
+    const cacheControl = response.headers.get('cache-control') ?? '';
+    const hasValidators = response.headers.has('etag') || response.headers.has('last-modified');
+    const storable = response.status === 200 && !!response.body
+      && !/no-store/i.test(cacheControl)
+      && (ttl > 0 || hasValidators);
+
+    if (!storable) {
+      if (loadIndex().has(key) && response.ok) removeEntry(key);
+      return read(response);
+    }
+    return read(storeWhileReading(key, response));
+  };
+
+  if (!cached?.etag && !cached?.lastModified) {
+    return scheduledFetch(url, init, download, shareAs);
+  }
+
+  const headers: Record<string, string> = { ...init.headers };
+  if (cached.etag) headers['If-None-Match'] = cached.etag;
+  if (cached.lastModified) headers['If-Modified-Since'] = cached.lastModified;
+
+  pin(key);
+  let result: T | typeof NOT_CACHED;
+  try {
+    result = await scheduledFetch<T | typeof NOT_CACHED>(url, { ...init, headers }, async (response) => {
+      if (response.status !== 304) return download(response);
+      // Pinned, but the entry can still be replaced or dropped by another
+      // request for the same URL
+      const entry = loadIndex().get(key);
+      if (!entry) {
+        await response.body?.cancel().catch(() => {});
+        return NOT_CACHED;
+      }
+      stats.revalidated++;
+      entry.storedAt = Date.now();
+      return read(diskResponse(key, entry));
+    }, shareAs);
+  } finally {
+    unpin(key);
+  }
+  if (result !== NOT_CACHED) return result;
+
+  // A 304 has no body to hand over - fetch again without validators (after
+  // the conditional request released its host slot)
+  return scheduledFetch(url, init, download, shareAs);
+}
+
+/**
+ * Cache counters since startup plus current size
+ */
+export function getHttpCacheStats(): HttpCacheStats {
+  const entries = loadIndex();
+  let size = 0;
+  for (const entry of entries.values()) size += entry.size;
+  return { ...stats, entries: entries.size, size };
+}
+
+/**
+ * Write pending index changes (call before quitting)
+ */
+export function flushHttpCache(): void {
+  if (saveTimer) {
+    clearTimeout(saveTimer);
+    saveTimer = null;
+  }
+  saveIndex();
+}
@@ -0,0 +1,126 @@
+/**
+ * Incremental JSON array parser
+ *
+ * Splits a top-level JSON array into its elements as text arrives, parsing
+ * each element on its own. Only the unfinished element is buffered, so a
+ * large API response (e.g. a 90 MB Xtream catalog) is never held as one
+ * string. Elements are emitted in batches via drain().
+ */
+
+const OPEN_BRACKET = 91;   // [
+const CLOSE_BRACKET = 93;  // ]
+const OPEN_BRACE = 123;    // {
+const CLOSE_BRACE = 125;   // }
+const QUOTE = 34;          // "
+const BACKSLASH = 92;      // \
+const COMMA = 44;          // ,
+
+function isWhitespace(c: number): boolean {
+  return c === 32 || c === 10 || c === 13 || c === 9;
+}
+
+export class JsonArrayStreamParser {
+  private buffer = '';
+  private pos = 0;               // Scan position in buffer
+  private elementStart = -1;     // Start of the element being scanned
+  private depth = 0;             // Nesting depth inside the current element
+  private inString = false;
+  private escaped = false;
+  private started = false;       // Seen the opening [
+  private finished = false;      // Seen the closing ]
+  private pending: unknown[] = [];
+  private parsedCount = 0;
+
+  get count(): number {
+    return this.parsedCount;
+  }
+
+  get pendingCount(): number {
+    return this.pending.length;
+  }
+
+  push(chunk: string): void {
+    if (this.finished) return;
+    this.buffer += chunk;
+    const buf = this.buffer;
+
+    for (let i = this.pos; i < buf.length; i++) {
+      const c = buf.charCodeAt(i);
+
+      if (this.inString) {
+        if (this.escaped) this.escaped = false;
+        else if (c === BACKSLASH) this.escaped = true;
+        else if (c === QUOTE) this.inString = false;
+        continue;
+      }
+
+      if (!this.started) {
+        if (isWhitespace(c) || c === 0xfeff) continue;
+        if (c !== OPEN_BRACKET) throw new Error('Expected a JSON array');
+        this.started = true;
+        continue;
+      }
+
+      if (this.elementStart === -1) {
+        // Between elements
+        if (isWhitespace(c) || c === COMMA) continue;
+        if (c === CLOSE_BRACKET) {
+          this.finished = true;
+          break;
+        }
+        this.elementStart = i;
+      }
+
+      if (c === QUOTE) {
+        this.inString = true;
+      } else if (c === OPEN_BRACE || c === OPEN_BRACKET) {
+        this.depth++;
+      } else if (this.depth > 0 && (c === CLOSE_BRACE || c === CLOSE_BRACKET)) {
+        // End of an object / array element
+        if (--this.depth === 0) this.emit(buf.substring(this.elementStart, i + 1));
+      } else if (this.depth === 0 && (c === COMMA || c === CLOSE_BRACKET)) {
+        // End of a scalar element (string, number, true/false/null)
+        this.emit(buf.substring(this.elementStart, i));
+        if (c === CLOSE_BRACKET) {
+          this.finished = true;
+          break;
+        }
+      }
+    }
+
+    // Drop everything before the unfinished element
+    const keepFrom = this.elementStart === -1 ? buf.length : this.elementStart;
+    this.buffer = buf.substring(keepFrom);
+    this.pos = buf.length - keepFrom;
+    if (this.elementStart !== -1) this.elementStart = 0;
+  }
+
+  private emit(text: string): void {
+    this.pending.push(JSON.parse(text));
+    this.parsedCount++;
+    this.elementStart = -1;
+  }
+
+  /**
+   * Take up to `max` parsed elements (all of them by default)
+   */
+  drain(max = Infinity): unknown[] {
+    if (max >= this.pending.length) {
+      const out = this.pending;
+      this.pending = [];
+      return out;
+    }
+    return this.pending.splice(0, max);
+  }
+
+  /**
+   * Signal end of input - returns remaining elements
+   */
+  end(): unknown[] {
+    if (!this.finished) {
+      throw new Error(this.started ? 'Unexpected end of JSON array' : 'Expected a JSON array');
+    }
+    this.buffer = '';
+    return this.drain();
+  }
+}
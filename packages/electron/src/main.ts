@@ -1,11 +1,16 @@
-import { app, BrowserWindow, ipcMain, net as electronNet, dialog } from 'electron';
+import { app, BrowserWindow, ipcMain, dialog, MessageChannelMain, type WebContents } from 'electron';
 import * as path from 'path';
 import { spawn, ChildProcess, execFileSync } from 'child_process';
 import * as net from 'net';
 import * as fs from 'fs';
+import { randomUUID } from 'crypto';
 import { fileURLToPath } from 'url';
 import type { Source } from '@sbtltv/core';
 import * as storage from './storage.js';
+import { JsonArrayStreamParser } from './json-array-parser.js';
+import { BODY_IDLE_TIMEOUT_MS, getFetchStats } from './fetch-scheduler.js';
+import { cachedFetch, getHttpCacheStats, flushHttpCache } from './http-cache.js';
+import * as catalog from './catalog-store.js';
 
 // ESM equivalent of __dirname
 const __filename = fileURLToPath(import.meta.url);
@@ -15,7 +20,18 @@ const __dirname = path.dirname(__filename);
 const MIN_WIDTH = 640;
 const MIN_HEIGHT = 620;
 
+// Sync daemon crash restarts: 1 s, 2 s, 4 s, ... at most 5 per 10 minutes
+const SYNC_DAEMON_RESTART_BASE_MS = 1000;
+const SYNC_DAEMON_MAX_RESTARTS = 5;
+const SYNC_DAEMON_RESTART_WINDOW_MS = 10 * 60 * 1000;
+
 let mainWindow: BrowserWindow | null = null;
+// Hidden window running the background sync daemon (renderer route #sync-daemon)
+let syncWindow: BrowserWindow | null = null;
+// Restart times of the daemon window after crashes (within the restart window)
+let syncRestarts: number[] = [];
+let syncRestartTimer: ReturnType<typeof setTimeout> | null = null;
+let isQuitting = false;
 let mpvProcess: ChildProcess | null = null;
 let mpvSocket: net.Socket | null = null;
 let requestId = 0;
@@ -69,25 +85,116 @@ async function createWindow(): Promise<void> {
     },
   });
 
-  // Load the React app
-  // In dev, load from Vite server; in prod, load from built files
+  mainWindow.on('closed', () => {
+    mainWindow = null;
+    killMpv();
+    // The daemon has no UI of its own - without this window-all-closed never fires
+    if (syncRestartTimer) clearTimeout(syncRestartTimer);
+    syncRestartTimer = null;
+    syncWindow?.destroy();
+  });
+
+  createSyncWindow();
+  await loadRenderer(mainWindow);
   if (process.argv.includes('--dev')) {
-    await mainWindow.loadURL('http://localhost:5173');
     mainWindow.webContents.openDevTools({ mode: 'detach' });
+  }
+}
+
+// Load the React app
+// In dev, load from Vite server; in prod, load from built files
+async function loadRenderer(win: BrowserWindow, hash?: string): Promise<void> {
+  if (process.argv.includes('--dev')) {
+    await win.loadURL(`http://localhost:5173${hash ? `#${hash}` : ''}`);
   } else {
     // Packaged app: UI is in resources/ui, unpackaged: relative path
     const uiPath = app.isPackaged
       ? path.join(process.resourcesPath, 'ui', 'index.html')
       : path.join(__dirname, '../../ui/dist/index.html');
-    await mainWindow.loadFile(uiPath);
+    await win.loadFile(uiPath, { hash });
   }
+}
 
-  mainWindow.on('closed', () => {
-    mainWindow = null;
-    killMpv();
+// The sync daemon runs startup/scheduled syncs and manual sync requests in a
+// hidden renderer so they never compete with the UI's main thread. It has to
+// be a renderer (not a utility process) because the data lives in the UI's
+// IndexedDB, which only a window of the same origin can open.
+function createSyncWindow(): void {
+  if (syncWindow) return;
+  syncWindow = new BrowserWindow({
+    show: false,
+    webPreferences: {
+      preload: path.join(__dirname, 'preload.cjs'),
+      contextIsolation: true,
+      nodeIntegration: false,
+      // Hidden windows are throttled by default, which would stall the sync timers
+      backgroundThrottling: false,
+    },
+  });
+
+  const win = syncWindow;
+  win.webContents.on('render-process-gone', (_event, details) => {
+    console.error('[Sync Daemon] Renderer gone:', details.reason);
+    win.destroy();
+  });
+  win.on('closed', () => {
+    if (syncWindow === win) syncWindow = null;
+    // Restart after a crash while the app is still open
+    if (mainWindow && !isQuitting) scheduleSyncWindowRestart();
+  });
+
+  loadRenderer(win, 'sync-daemon').catch((error) => {
+    console.error('[Sync Daemon] Failed to load:', error);
   });
 }
 
+// Restart the daemon after a crash with exponential backoff. A daemon that
+// keeps crashing (bad migration, out of memory during a sync) is given up on
+// after SYNC_DAEMON_MAX_RESTARTS within SYNC_DAEMON_RESTART_WINDOW_MS.
+function scheduleSyncWindowRestart(): void {
+  if (syncRestartTimer) return;
+  const now = Date.now();
+  syncRestarts = syncRestarts.filter((time) => now - time < SYNC_DAEMON_RESTART_WINDOW_MS);
+  if (syncRestarts.length >= SYNC_DAEMON_MAX_RESTARTS) {
+    console.error(
+      `[Sync Daemon] Crashed ${syncRestarts.length + 1} times in ${SYNC_DAEMON_RESTART_WINDOW_MS / 60_000} minutes, ` +
+      'not restarting - background sync is off until the app is restarted'
+    );
+    return;
+  }
+
+  const delay = SYNC_DAEMON_RESTART_BASE_MS * 2 ** syncRestarts.length;
+  syncRestarts.push(now);
+  console.log(`[Sync Daemon] Restarting in ${delay} ms`);
+  syncRestartTimer = setTimeout(() => {
+    syncRestartTimer = null;
+    if (mainWindow && !isQuitting) createSyncWindow();
+  }, delay);
+}
+
+// Both ends of the daemon connection, registered when each window asks for it
+let syncDaemonContents: WebContents | null = null;
+let syncUiContents: WebContents | null = null;
+
+// Give the daemon and the UI window a fresh MessageChannel. Runs whenever
+// either side (re)loads; the daemon drops its previous port.
+function connectSyncDaemon(): void {
+  if (!syncDaemonContents || syncDaemonContents.isDestroyed()) return;
+  if (!syncUiContents || syncUiContents.isDestroyed()) return;
+  const { port1, port2 } = new MessageChannelMain();
+  syncDaemonContents.postMessage('sync-daemon-port', null, [port1]);
+  syncUiContents.postMessage('sync-daemon-port', null, [port2]);
+}
+
+ipcMain.on('sync-daemon-connect', (event, role: 'daemon' | 'ui') => {
+  if (role === 'daemon') {
+    syncDaemonContents = event.sender;
+  } else {
+    syncUiContents = event.sender;
+  }
+  connectSyncDaemon();
+});
+
 function killMpv(): void {
   isShuttingDown = true;
   if (mpvSocket) {
@@ -607,6 +714,14 @@ ipcMain.handle('storage-is-encryption-available', async () => {
 });
 
 // IPC Handler - Import M3U file via file dialog
+// Files picked for import, by import id. The renderer only ever sees the id;
+// the contents are streamed to it with stream-m3u-import.
+const pendingM3UImports = new Map<string, string>();
+
+// Chunks sent to the renderer that it has not acknowledged yet. Reading
+// pauses at this limit so a slow parser doesn't queue the whole file in memory.
+const M3U_STREAM_MAX_UNACKED = 8;
+
 ipcMain.handle('import-m3u-file', async () => {
   if (!mainWindow) return { error: 'No window available' };
 
@@ -626,27 +741,58 @@ ipcMain.handle('import-m3u-file', async () => {
   const filePath = result.filePaths[0];
 
   try {
-    const content = fs.readFileSync(filePath, 'utf-8');
+    const { size } = await fs.promises.stat(filePath);
+    const importId = randomUUID();
+    pendingM3UImports.set(importId, filePath);
     const fileName = path.basename(filePath, path.extname(filePath));
-    return { success: true, data: { content, fileName } };
+    return { success: true, data: { importId, fileName, size } };
   } catch (error) {
     return { error: error instanceof Error ? error.message : 'Failed to read file' };
   }
 });
 
-// URL allowlist for fetch-binary (TMDB exports only) - prevents SSRF attacks
-const ALLOWED_BINARY_FETCH_DOMAINS = [
-  'files.tmdb.org',       // TMDB daily exports (gzipped)
-];
+// Stream a picked M3U file to the renderer over a MessagePort (posted on the
+// 'm3u-import-port' channel). The file is read in chunks, never as a whole.
+ipcMain.handle('stream-m3u-import', async (event, importId: string) => {
+  const filePath = pendingM3UImports.get(importId);
+  if (!filePath) return { error: 'Unknown import' };
+  pendingM3UImports.delete(importId);
+
+  const { port1, port2 } = new MessageChannelMain();
+  const stream = fs.createReadStream(filePath);
+  let unacked = 0;
+
+  port1.on('message', (message) => {
+    if (message.data?.type === 'ack') {
+      unacked--;
+      if (unacked < M3U_STREAM_MAX_UNACKED && stream.isPaused()) stream.resume();
+    } else if (message.data?.type === 'cancel') {
+      stream.destroy();
+      port1.close();
+    }
+  });
+  // Renderer went away (worker terminated, window reloaded)
+  port1.on('close', () => stream.destroy());
+  port1.start();
+
+  stream.on('data', (chunk) => {
+    const bytes = chunk as Buffer;
+    port1.postMessage({ type: 'chunk', data: new Uint8Array(bytes.buffer, bytes.byteOffset, bytes.byteLength) });
+    unacked++;
+    if (unacked >= M3U_STREAM_MAX_UNACKED) stream.pause();
+  });
+  stream.on('end', () => {
+    port1.postMessage({ type: 'end' });
+    port1.close();
+  });
+  stream.on('error', (error) => {
+    port1.postMessage({ type: 'error', error: error.message });
+    port1.close();
+  });
 
-function isAllowedBinaryUrl(url: string): boolean {
-  try {
-    const parsed = new URL(url);
-    return ALLOWED_BINARY_FETCH_DOMAINS.some(domain => parsed.hostname === domain || parsed.hostname.endsWith('.' + domain));
-  } catch {
-    return false;
-  }
-}
+  event.sender.postMessage('m3u-import-port', { importId }, [port2]);
+  return { success: true };
+});
 
 // SSRF protection - block requests to internal/private networks
 // These patterns match localhost, private IP ranges, and cloud metadata endpoints
@@ -665,35 +811,51 @@ function isBlockedUrl(url: string): boolean {
   return BLOCKED_URL_PATTERNS.some(pattern => pattern.test(url));
 }
 
+// Elements per message in fetch-json-array
+const JSON_ARRAY_BATCH_SIZE = 1000;
+
+// SSRF protection for proxied fetches (unless LAN sources are allowed)
+// Returns an error message when the URL must not be fetched
+function checkProxyUrl(url: string): string | null {
+  const settings = storage.getSettings();
+  if (!settings.allowLanSources && isBlockedUrl(url)) {
+    return 'Blocked: Local network access is disabled. Enable "Allow LAN sources" in Settings > Security if you trust this source.';
+  }
+  return null;
+}
+
 // Fetch proxy - bypasses CORS by making requests from main process
 // Used for IPTV provider API calls (user-configured URLs)
 // Blocks internal network access unless allowLanSources is enabled in settings
-ipcMain.handle('fetch-proxy', async (_event, url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) => {
+// responseType 'arraybuffer' returns the raw body (e.g. gzipped XMLTV) instead of decoded text
+// Requests go through the fetch scheduler (per-host limits, timeouts, retries);
+// identical concurrent GETs share one network request, and GETs are served
+// from / revalidated against the on-disk HTTP cache
+ipcMain.handle('fetch-proxy', async (_event, url: string, options?: { method?: string; headers?: Record<string, string>; body?: string; responseType?: 'text' | 'arraybuffer' }) => {
   try {
-    // Check SSRF protection (unless LAN sources are allowed)
-    const settings = storage.getSettings();
-    if (!settings.allowLanSources && isBlockedUrl(url)) {
-      return {
-        success: false,
-        error: 'Blocked: Local network access is disabled. Enable "Allow LAN sources" in Settings > Security if you trust this source.',
-      };
+    const blocked = checkProxyUrl(url);
+    if (blocked) {
+      return { success: false, error: blocked };
     }
 
-    const response = await electronNet.fetch(url, {
+    const init = {
       method: options?.method || 'GET',
       headers: options?.headers,
       body: options?.body,
-    });
-    const text = await response.text();
-    return {
-      success: true,
-      data: {
+    };
+    const data = await cachedFetch(url, init, async (response) => {
+      const meta = {
         ok: response.ok,
         status: response.status,
         statusText: response.statusText,
-        text,
-      },
-    };
+        headers: Object.fromEntries(response.headers.entries()),
+      };
+      if (options?.responseType === 'arraybuffer') {
+        return { ...meta, text: '', body: new Uint8Array(await response.arrayBuffer()) };
+      }
+      return { ...meta, text: await response.text() };
+    }, `proxy:${options?.responseType ?? 'text'}`);
+    return { success: true, data };
   } catch (error) {
     return {
       success: false,
@@ -702,33 +864,255 @@ ipcMain.handle('fetch-proxy', async (_event, url: string, options?: { method?: s
   }
 });
 
-// Fetch binary - for gzipped/binary content, returns base64
-// Restricted to TMDB exports only (prevents SSRF with binary data)
-ipcMain.handle('fetch-binary', async (_event, url: string) => {
-  if (!isAllowedBinaryUrl(url)) {
-    return { success: false, error: `Domain not allowed for binary fetch: ${new URL(url).hostname}` };
+// Messages a streamed response may have sent but the renderer has not
+// acknowledged yet. Reading pauses at this limit so a slow consumer doesn't
+// buffer the download.
+const FETCH_STREAM_MAX_UNACKED = 8;
+
+interface ResponsePort {
+  readonly cancelled: boolean;
+  post: (message: unknown) => void;
+  // Resolves once the renderer has room for another message; throws if it
+  // stops acknowledging, so the download doesn't hold a host slot forever
+  waitForRoom: () => Promise<void>;
+  close: () => void;
+}
+
+// MessagePort carrying a streamed response body to the renderer, delivered
+// on the 'fetch-stream-port' channel. The renderer acknowledges each message
+// and can cancel through the port; closing the port (worker terminated,
+// window reloaded) cancels too.
+function openResponsePort(sender: WebContents, streamId: string): ResponsePort {
+  const { port1, port2 } = new MessageChannelMain();
+  let cancelled = false;
+  let unacked = 0;
+  let resume: (() => void) | null = null;
+  const wake = () => {
+    resume?.();
+    resume = null;
+  };
+
+  port1.on('message', (message) => {
+    if (message.data?.type === 'ack') {
+      unacked--;
+      wake();
+    } else if (message.data?.type === 'cancel') {
+      cancelled = true;
+      wake();
+      port1.close();
+    }
+  });
+  port1.on('close', () => {
+    cancelled = true;
+    wake();
+  });
+  port1.start();
+  sender.postMessage('fetch-stream-port', { streamId }, [port2]);
+
+  return {
+    get cancelled() {
+      return cancelled;
+    },
+    post(message) {
+      port1.postMessage(message);
+      unacked++;
+    },
+    async waitForRoom() {
+      while (unacked >= FETCH_STREAM_MAX_UNACKED && !cancelled) {
+        const acked = await new Promise<boolean>((wakeUp) => {
+          const timer = setTimeout(() => wakeUp(false), BODY_IDLE_TIMEOUT_MS);
+          resume = () => {
+            clearTimeout(timer);
+            wakeUp(true);
+          };
+        });
+        if (!acked) throw new Error('Stream consumer stalled');
+      }
+    },
+    close() {
+      port1.close();
+    },
+  };
+}
+
+// Fetch a JSON array (e.g. Xtream catalogs) and parse it incrementally while
+// it downloads. Resolves with the status once headers arrive; the elements
+// follow over a response port, one structured-cloned message per
+// JSON_ARRAY_BATCH_SIZE elements, so neither the response text nor the whole
+// array crosses IPC at once.
+ipcMain.handle('fetch-json-array', async (event, streamId: string, url: string) => {
+  const blocked = checkProxyUrl(url);
+  if (blocked) {
+    return { success: false, error: blocked };
   }
+
+  const port = openResponsePort(event.sender, streamId);
+  return new Promise((resolve) => {
+    let answered = false;
+    cachedFetch(url, {}, async (response) => {
+      answered = true;
+      resolve({
+        success: true,
+        data: { ok: response.ok, status: response.status, statusText: response.statusText },
+      });
+
+      // Errors are reported on the port rather than thrown: batches already
+      // delivered can't be taken back, so the request isn't retried
+      const reader = response.ok ? response.body?.getReader() : undefined;
+      try {
+        if (reader) {
+          const parser = new JsonArrayStreamParser();
+          const decoder = new TextDecoder();
+          const send = async (items: unknown[]) => {
+            if (items.length === 0) return;
+            await port.waitForRoom();
+            if (!port.cancelled) port.post({ type: 'items', items });
+          };
+          while (!port.cancelled) {
+            const { done, value } = await reader.read();
+            if (done) {
+              parser.push(decoder.decode());
+              await send(parser.end());
+              break;
+            }
+            parser.push(decoder.decode(value, { stream: true }));
+            if (parser.pendingCount >= JSON_ARRAY_BATCH_SIZE) await send(parser.drain());
+          }
+        }
+        if (!port.cancelled) port.post({ type: 'end' });
+      } catch (error) {
+        if (!port.cancelled) port.post({ type: 'error', error: error instanceof Error ? error.message : 'Download failed' });
+      } finally {
+        (reader ?? response.body)?.cancel().catch(() => {});
+        port.close();
+      }
+    }).catch((error) => {
+      const message = error instanceof Error ? error.message : 'Fetch failed';
+      port.post({ type: 'error', error: message });
+      port.close();
+      if (!answered) resolve({ success: false, error: message });
+    });
+  });
+});
+
+// Streaming fetch proxy - resolves with status and headers as soon as they
+// arrive, then sends the body over a response port chunk by chunk, so
+// parsers in the renderer start on the first bytes.
+ipcMain.handle('fetch-stream', async (event, streamId: string, url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) => {
+  const blocked = checkProxyUrl(url);
+  if (blocked) {
+    return { success: false, error: blocked };
+  }
+
+  const port = openResponsePort(event.sender, streamId);
+  const init = {
+    method: options?.method || 'GET',
+    headers: options?.headers,
+    body: options?.body,
+  };
+
+  return new Promise((resolve) => {
+    let answered = false;
+    cachedFetch(url, init, async (response) => {
+      answered = true;
+      resolve({
+        success: true,
+        data: {
+          ok: response.ok,
+          status: response.status,
+          statusText: response.statusText,
+          headers: Object.fromEntries(response.headers.entries()),
+        },
+      });
+
+      // Body errors are reported on the port rather than thrown: chunks
+      // already delivered can't be taken back, so the request isn't retried
+      const reader = response.body?.getReader();
+      try {
+        while (reader && !port.cancelled) {
+          await port.waitForRoom();
+          if (port.cancelled) break;
+          const { done, value } = await reader.read();
+          if (done) break;
+          port.post({ type: 'chunk', data: value });
+        }
+        if (!port.cancelled) port.post({ type: 'end' });
+      } catch (error) {
+        if (!port.cancelled) port.post({ type: 'error', error: error instanceof Error ? error.message : 'Download failed' });
+      } finally {
+        reader?.cancel().catch(() => {});
+        port.close();
+      }
+    }).catch((error) => {
+      const message = error instanceof Error ? error.message : 'Fetch failed';
+      port.post({ type: 'error', error: message });
+      port.close();
+      if (!answered) resolve({ success: false, error: message });
+    });
+  });
+});
+
+// Per-host request statistics from the fetch scheduler
+ipcMain.handle('fetch-stats', () => {
+  return { success: true, data: getFetchStats() };
+});
+
+// Disk cache counters (hits, 304 revalidations, downloads) and size
+ipcMain.handle('http-cache-stats', () => {
+  return { success: true, data: getHttpCacheStats() };
+});
+
+// SQLite catalog backend (see catalog-store.ts). Every handler returns a
+// StorageResult; writes tell all windows to re-run their catalog queries.
+const CATALOG_KINDS = new Set<catalog.CatalogKind>(['movie', 'series', 'channel']);
+
+function catalogCall<T>(run: () => T): { success: boolean; data?: T; error?: string } {
   try {
-    const response = await electronNet.fetch(url);
-    if (!response.ok) {
-      return {
-        success: false,
-        error: `HTTP ${response.status}: ${response.statusText}`,
-      };
-    }
-    const buffer = await response.arrayBuffer();
-    const base64 = Buffer.from(buffer).toString('base64');
-    return {
-      success: true,
-      data: base64,
-    };
+    return { success: true, data: run() };
   } catch (error) {
-    return {
-      success: false,
-      error: error instanceof Error ? error.message : 'Fetch failed',
-    };
+    console.error('[Catalog] Query failed:', error);
+    return { success: false, error: error instanceof Error ? error.message : 'Catalog query failed' };
   }
-});
+}
+
+function checkCatalogKind(kind: catalog.CatalogKind): void {
+  if (!CATALOG_KINDS.has(kind)) throw new Error(`Unknown catalog kind: ${kind}`);
+}
+
+function notifyCatalogChanged(): void {
+  for (const win of BrowserWindow.getAllWindows()) {
+    win.webContents.send('catalog-changed');
+  }
+}
+
+ipcMain.handle('catalog-query', (_event, query: catalog.CatalogQuery) => catalogCall(() => {
+  checkCatalogKind(query.kind);
+  return catalog.queryCatalog(query);
+}));
+
+ipcMain.handle('catalog-categories', (_event, kind: catalog.CatalogKind) => catalogCall(() => {
+  checkCatalogKind(kind);
+  return catalog.getNonEmptyCategories(kind);
+}));
+
+ipcMain.handle('catalog-write', (_event, kind: catalog.CatalogKind, sourceId: string, syncId: number, rows: Record<string, unknown>[]) => catalogCall(() => {
+  checkCatalogKind(kind);
+  catalog.writeCatalogItems(kind, sourceId, syncId, rows);
+}));
+
+ipcMain.handle('catalog-finish', (_event, kind: catalog.CatalogKind, sourceId: string, syncId: number) => catalogCall(() => {
+  checkCatalogKind(kind);
+  const removed = catalog.finishCatalogSource(kind, sourceId, syncId);
+  notifyCatalogChanged();
+  return removed;
+}));
+
+ipcMain.handle('catalog-delete-source', (_event, sourceId: string) => catalogCall(() => {
+  catalog.deleteCatalogSource(sourceId);
+  notifyCatalogChanged();
+}));
+
+ipcMain.handle('catalog-stats', () => catalogCall(() => catalog.getCatalogStats()));
 
 // App lifecycle
 app.whenReady().then(async () => {
@@ -748,8 +1132,14 @@ app.on('window-all-closed', () => {
   }
 });
 
+app.on('before-quit', () => {
+  isQuitting = true;
+  flushHttpCache();
+  catalog.closeCatalogStore();
+});
+
 app.on('activate', () => {
-  if (BrowserWindow.getAllWindows().length === 0) {
+  if (!mainWindow) {
     createWindow();
   }
 });
@@ -51,10 +51,25 @@ export interface AppSettings {
 }
 
 export interface M3UImportResult {
-  content: string;
+  importId: string;   // Pass to streamM3UImport to receive the file contents
   fileName: string;
+  size: number;       // Bytes
 }
 
+// Messages on the MessagePort delivered for streamM3UImport
+// (main → renderer; the renderer answers each chunk with { type: 'ack' })
+export type M3UFileStreamMessage =
+  | { type: 'chunk'; data: Uint8Array }
+  | { type: 'end' }
+  | { type: 'error'; error: string };
+
+// Messages on a fetchJsonArray port: the array's elements in batches, parsed
+// while downloading (acknowledged and cancelled like a fetchStream port)
+export type FetchJsonArrayMessage =
+  | { type: 'items'; items: unknown[] }
+  | { type: 'end' }
+  | { type: 'error'; error: string };
+
 export interface StorageApi {
   getSources: () => Promise<StorageResult<Source[]>>;
   getSource: (id: string) => Promise<StorageResult<Source | undefined>>;
@@ -64,6 +79,9 @@ export interface StorageApi {
   updateSettings: (settings: Partial<AppSettings>) => Promise<StorageResult>;
   isEncryptionAvailable: () => Promise<StorageResult<boolean>>;
   importM3UFile: () => Promise<StorageResult<M3UImportResult> & { canceled?: boolean }>;
+  // Starts streaming an imported file. The port arrives as a window message
+  // { type: 'm3u-import-port', importId } with the port in event.ports.
+  streamM3UImport: (importId: string) => Promise<StorageResult>;
 }
 
 // Fetch proxy response
@@ -71,12 +89,125 @@ export interface FetchProxyResponse {
   ok: boolean;
   status: number;
   statusText: string;
-  text: string;
+  text: string;        // Empty when responseType is 'arraybuffer'
+  body?: Uint8Array;   // Raw (undecoded) body when responseType is 'arraybuffer'
+  headers?: Record<string, string>;  // Response headers (lower-case names)
+}
+
+// fetchJsonArray response: the status; the elements follow over a MessagePort
+export interface FetchJsonArrayResponse {
+  ok: boolean;
+  status: number;
+  statusText: string;
+}
+
+// Per-host request statistics from the main-process fetch scheduler
+export interface FetchHostStats {
+  host: string;
+  requests: number;       // Completed requests (after retries)
+  failures: number;       // Requests that failed for good
+  retries: number;
+  timeouts: number;
+  active: number;
+  queued: number;
+  avgLatencyMs: number;   // Time to response headers
+  maxLatencyMs: number;
+  coalescedHits: number;   // Requests that shared another caller's in-flight request
+  coalescedMisses: number; // Coalescable requests that went to the network
+  lastStatus?: number;
+  lastError?: string;
+}
+
+// fetchStream response: status and headers; the body follows over a MessagePort
+export interface FetchStreamResponse {
+  ok: boolean;
+  status: number;
+  statusText: string;
+  headers: Record<string, string>;  // Response headers (lower-case names)
+}
+
+// Messages on a fetchStream port (main → renderer). The renderer answers
+// each chunk with { type: 'ack' } and can stop the download with { type: 'cancel' }.
+export type FetchStreamMessage =
+  | { type: 'chunk'; data: Uint8Array }
+  | { type: 'end' }
+  | { type: 'error'; error: string };
+
+// Disk HTTP cache counters since startup, plus current size
+export interface HttpCacheStats {
+  hits: number;         // Served from disk without a request
+  revalidated: number;  // 304 - served from disk after a conditional request
+  misses: number;       // Body downloaded
+  bytesFromCache: number;
+  entries: number;
+  size: number;         // Bytes on disk
+}
+
+export interface FetchProxyOptions {
+  method?: string;
+  headers?: Record<string, string>;
+  body?: string;
+  responseType?: 'text' | 'arraybuffer';
 }
 
 export interface FetchProxyApi {
-  fetch: (url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) => Promise<StorageResult<FetchProxyResponse>>;
-  fetchBinary: (url: string) => Promise<StorageResult<string>>; // Returns base64-encoded data
+  fetch: (url: string, options?: FetchProxyOptions) => Promise<StorageResult<FetchProxyResponse>>;
+  // Same port relay as fetchStream; no elements arrive when !ok
+  fetchJsonArray: (streamId: string, url: string) => Promise<StorageResult<FetchJsonArrayResponse>>;
+  // Streaming fetch. Resolves once headers arrive; the body is sent over a
+  // MessagePort relayed as a window message { type: 'fetch-stream-port', streamId }.
+  fetchStream: (streamId: string, url: string, options?: FetchProxyOptions) => Promise<StorageResult<FetchStreamResponse>>;
+  getStats: () => Promise<StorageResult<FetchHostStats[]>>;
+  getCacheStats: () => Promise<StorageResult<HttpCacheStats>>;
+}
+
+// SQLite catalog backend (selected with the catalogBackend setting)
+export type CatalogKind = 'movie' | 'series' | 'channel';
+
+export interface CatalogCursor {
+  key: string | number;  // name or added of the last row
+  rowid: number;
+}
+
+export interface CatalogQuery {
+  kind: CatalogKind;
+  categoryId?: string;
+  search?: string;              // Every word must prefix-match a word of the name
+  order?: 'name' | 'added';     // name ascending (default) or newest first
+  limit: number;
+  after?: CatalogCursor;        // Continue after the last row of the previous page
+}
+
+export interface CatalogPage<T = unknown> {
+  items: T[];
+  next?: CatalogCursor;  // Undefined on the last page
+}
+
+export interface CatalogStats {
+  movies: number;
+  series: number;
+  channels: number;
+  size: number;  // Database file size in bytes
+}
+
+export interface CatalogApi {
+  query: (query: CatalogQuery) => Promise<StorageResult<CatalogPage>>;
+  // Category ids of a kind with at least one item
+  categories: (kind: CatalogKind) => Promise<StorageResult<string[]>>;
+  // Mirror a source's rows: write() batches tagged with syncId, then finish()
+  // drops the source's rows of that kind not written by the sync
+  write: (kind: CatalogKind, sourceId: string, syncId: number, rows: unknown[]) => Promise<StorageResult>;
+  finish: (kind: CatalogKind, sourceId: string, syncId: number) => Promise<StorageResult<number>>;
+  deleteSource: (sourceId: string) => Promise<StorageResult>;
+  getStats: () => Promise<StorageResult<CatalogStats>>;
+  // Called after every write to the catalog; returns an unsubscribe function
+  onChanged: (callback: () => void) => () => void;
+}
+
+export interface SyncDaemonApi {
+  // Ask the main process to (re)connect this window to the sync daemon. Each
+  // side receives its end of a MessagePort as a window message { type: 'sync-daemon-port' }.
+  connect: (role: 'daemon' | 'ui') => void;
 }
 
 // Expose window control API
@@ -130,16 +261,56 @@ contextBridge.exposeInMainWorld('storage', {
   updateSettings: (settings: Partial<AppSettings>) => ipcRenderer.invoke('storage-update-settings', settings),
   isEncryptionAvailable: () => ipcRenderer.invoke('storage-is-encryption-available'),
   importM3UFile: () => ipcRenderer.invoke('import-m3u-file'),
+  streamM3UImport: (importId: string) => ipcRenderer.invoke('stream-m3u-import', importId),
 } satisfies StorageApi);
 
+// MessagePorts can't cross the context bridge - relay them with window.postMessage
+ipcRenderer.on('m3u-import-port', (event: IpcRendererEvent, data: { importId: string }) => {
+  window.postMessage({ type: 'm3u-import-port', importId: data.importId }, '*', event.ports);
+});
+ipcRenderer.on('fetch-stream-port', (event: IpcRendererEvent, data: { streamId: string }) => {
+  window.postMessage({ type: 'fetch-stream-port', streamId: data.streamId }, '*', event.ports);
+});
+ipcRenderer.on('sync-daemon-port', (event: IpcRendererEvent) => {
+  window.postMessage({ type: 'sync-daemon-port' }, '*', event.ports);
+});
+
 // Expose fetch proxy API - bypasses CORS for API calls
 contextBridge.exposeInMainWorld('fetchProxy', {
-  fetch: (url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) =>
+  fetch: (url: string, options?: FetchProxyOptions) =>
     ipcRenderer.invoke('fetch-proxy', url, options),
-  fetchBinary: (url: string) =>
-    ipcRenderer.invoke('fetch-binary', url),
+  fetchJsonArray: (streamId: string, url: string) =>
+    ipcRenderer.invoke('fetch-json-array', streamId, url),
+  fetchStream: (streamId: string, url: string, options?: FetchProxyOptions) =>
+    ipcRenderer.invoke('fetch-stream', streamId, url, options),
+  getStats: () => ipcRenderer.invoke('fetch-stats'),
+  getCacheStats: () => ipcRenderer.invoke('http-cache-stats'),
 } satisfies FetchProxyApi);
 
+// Expose SQLite catalog queries
+contextBridge.exposeInMainWorld('catalog', {
+  query: (query: CatalogQuery) => ipcRenderer.invoke('catalog-query', query),
+  categories: (kind: CatalogKind) => ipcRenderer.invoke('catalog-categories', kind),
+  write: (kind: CatalogKind, sourceId: string, syncId: number, rows: unknown[]) =>
+    ipcRenderer.invoke('catalog-write', kind, sourceId, syncId, rows),
+  finish: (kind: CatalogKind, sourceId: string, syncId: number) =>
+    ipcRenderer.invoke('catalog-finish', kind, sourceId, syncId),
+  deleteSource: (sourceId: string) => ipcRenderer.invoke('catalog-delete-source', sourceId),
+  getStats: () => ipcRenderer.invoke('catalog-stats'),
+  onChanged: (callback: () => void) => {
+    const listener = () => callback();
+    ipcRenderer.on('catalog-changed', listener);
+    return () => {
+      ipcRenderer.removeListener('catalog-changed', listener);
+    };
+  },
+} satisfies CatalogApi);
+
+// Expose sync daemon connection (background sync runs in a hidden window)
+contextBridge.exposeInMainWorld('syncDaemon', {
+  connect: (role: 'daemon' | 'ui') => ipcRenderer.send('sync-daemon-connect', role),
+} satisfies SyncDaemonApi);
+
 // Expose platform info for conditional UI (e.g., resize grip on Windows only)
 contextBridge.exposeInMainWorld('platform', {
   isWindows: process.platform === 'win32',
@@ -17,6 +17,8 @@ interface StoredSource {
   enabled: boolean;
   epg_url?: string;
   auto_load_epg?: boolean; // Auto-fetch EPG from source (default: true for xtream)
+  epg_mode?: 'full' | 'on_demand';
+  fetch_by_category?: boolean;
   // Xtream-specific (encrypted)
   username?: string;
   encryptedPassword?: string; // Base64 encoded encrypted buffer
@@ -28,11 +30,14 @@ interface AppSettings {
   tmdbApiKey?: string;  // Decrypted value returned to callers
   vodRefreshHours: number;  // 0 = manual only, default 24
   epgRefreshHours: number;  // 0 = manual only, default 6
+  epgRetentionPastHours: number;   // EPG history kept, default 24
+  epgRetentionFutureDays: number;  // EPG look-ahead kept (0 = all), default 3
   movieGenresEnabled?: number[];   // TMDB genre IDs to show as carousels
   seriesGenresEnabled?: number[];  // TMDB genre IDs for TV shows
   posterDbApiKey?: string;         // RatingPosterDB API key
   rpdbBackdropsEnabled?: boolean;  // Use RPDB for backdrop images (tier 2+)
   allowLanSources?: boolean;       // Allow requests to LAN IPs (SSRF protection bypass)
+  catalogBackend?: 'indexeddb' | 'sqlite';  // Catalog query backend, default indexeddb
 }
 
 // Internal storage format (encrypted)
@@ -42,11 +47,14 @@ interface StoredSettings {
   encryptedTmdbApiKey?: string;  // Base64 encoded encrypted buffer
   vodRefreshHours: number;
   epgRefreshHours: number;
+  epgRetentionPastHours?: number;
+  epgRetentionFutureDays?: number;
   movieGenresEnabled?: number[];   // TMDB genre IDs to show as carousels
   seriesGenresEnabled?: number[];  // TMDB genre IDs for TV shows
   encryptedPosterDbApiKey?: string; // Base64 encoded encrypted buffer
   rpdbBackdropsEnabled?: boolean;   // Use RPDB for backdrop images
   allowLanSources?: boolean;        // Allow requests to LAN IPs
+  catalogBackend?: 'indexeddb' | 'sqlite';
 }
 
 const store = new Store<StoreSchema>({
@@ -100,6 +108,8 @@ export function getSources(): Source[] {
       enabled: s.enabled,
       epg_url: s.epg_url,
       auto_load_epg: s.auto_load_epg,
+      epg_mode: s.epg_mode,
+      fetch_by_category: s.fetch_by_category,
     };
     if (s.type === 'xtream' && s.username) {
       source.username = s.username;
@@ -132,6 +142,8 @@ export function saveSource(source: Source): void {
     enabled: source.enabled,
     epg_url: source.epg_url,
     auto_load_epg: source.auto_load_epg,
+    epg_mode: source.epg_mode,
+    fetch_by_category: source.fetch_by_category,
   };
 
   if (source.type === 'xtream') {
@@ -172,6 +184,8 @@ export function getSettings(): AppSettings {
     lastSourceId: stored.lastSourceId,
     vodRefreshHours: stored.vodRefreshHours ?? 24,
     epgRefreshHours: stored.epgRefreshHours ?? 6,
+    epgRetentionPastHours: stored.epgRetentionPastHours ?? 24,
+    epgRetentionFutureDays: stored.epgRetentionFutureDays ?? 3,
     movieGenresEnabled: stored.movieGenresEnabled,
     seriesGenresEnabled: stored.seriesGenresEnabled,
   };
@@ -183,6 +197,7 @@ export function getSettings(): AppSettings {
   }
   result.rpdbBackdropsEnabled = stored.rpdbBackdropsEnabled ?? false;
   result.allowLanSources = stored.allowLanSources ?? false;
+  result.catalogBackend = stored.catalogBackend ?? 'indexeddb';
   return result;
 }
 
@@ -200,6 +215,8 @@ export function updateSettings(settings: Partial<AppSettings>): void {
   }
   if (settings.vodRefreshHours !== undefined) updated.vodRefreshHours = settings.vodRefreshHours;
   if (settings.epgRefreshHours !== undefined) updated.epgRefreshHours = settings.epgRefreshHours;
+  if (settings.epgRetentionPastHours !== undefined) updated.epgRetentionPastHours = settings.epgRetentionPastHours;
+  if (settings.epgRetentionFutureDays !== undefined) updated.epgRetentionFutureDays = settings.epgRetentionFutureDays;
   if (settings.movieGenresEnabled !== undefined) updated.movieGenresEnabled = settings.movieGenresEnabled;
   if (settings.seriesGenresEnabled !== undefined) updated.seriesGenresEnabled = settings.seriesGenresEnabled;
   if (settings.posterDbApiKey !== undefined) {
@@ -211,6 +228,9 @@ export function updateSettings(settings: Partial<AppSettings>): void {
   if (settings.allowLanSources !== undefined) {
     updated.allowLanSources = settings.allowLanSources;
   }
+  if (settings.catalogBackend !== undefined) {
+    updated.catalogBackend = settings.catalogBackend;
+  }
 
   store.set('settings', updated);
 }
@@ -0,0 +1,153 @@
+/**
+ * EXTINF parser throughput benchmark
+ *
+ * Compares the original per-attribute regex parser (which only read four
+ * attributes), the same parser extended to collect every attribute, and the
+ * single-pass attribute scanner on the #EXTINF lines of a generated playlist.
+ * Then times the full streaming M3U parser on the same playlist fed in 64 KB
+ * chunks.
+ *
+ * Run: pnpm --filter @sbtltv/local-adapter bench:m3u [entryCount]
+ */
+
+import { M3UStreamParser, parseExtInf } from '../src/m3u-parser';
+
+const ENTRY_COUNT = Number(process.argv[2]) || 500_000;
+const CHUNK_SIZE = 64 * 1024;
+const RUNS = 3;
+
+// ===========================================================================
+// Baseline: regex parser as previously implemented in m3u-parser.ts
+// ===========================================================================
+
+interface RegexMetadata {
+  duration: number;
+  tvgId: string;
+  tvgName: string;
+  tvgLogo: string;
+  groupTitle: string;
+  displayName: string;
+}
+
+// Same, plus a generic pass collecting every other attribute (what the
+// scanner does) for a like-for-like comparison
+function parseExtInfRegexAll(line: string): RegexMetadata & { attributes?: Record<string, string> } {
+  const metadata: RegexMetadata & { attributes?: Record<string, string> } = parseExtInfRegex(line);
+  const attrPattern = /([\w-]+)="([^"]*)"/g;
+  let match;
+  while ((match = attrPattern.exec(line)) !== null) {
+    const key = match[1].toLowerCase();
+    if (key !== 'tvg-id' && key !== 'tvg-name' && key !== 'tvg-logo' && key !== 'group-title') {
+      (metadata.attributes ??= {})[key] = match[2];
+    }
+  }
+  return metadata;
+}
+
+function parseExtInfRegex(line: string): RegexMetadata {
+  const metadata: RegexMetadata = {
+    duration: -1,
+    tvgId: '',
+    tvgName: '',
+    tvgLogo: '',
+    groupTitle: '',
+    displayName: '',
+  };
+
+  const content = line.substring(8);
+  const commaIndex = content.lastIndexOf(',');
+  if (commaIndex !== -1) {
+    metadata.displayName = content.substring(commaIndex + 1).trim();
+  }
+  const attrPart = commaIndex !== -1 ? content.substring(0, commaIndex) : content;
+
+  const durationMatch = attrPart.match(/^(-?\d+)/);
+  if (durationMatch) metadata.duration = parseInt(durationMatch[1], 10);
+  const tvgIdMatch = attrPart.match(/tvg-id="([^"]*)"/i);
+  if (tvgIdMatch) metadata.tvgId = tvgIdMatch[1];
+  const tvgNameMatch = attrPart.match(/tvg-name="([^"]*)"/i);
+  if (tvgNameMatch) metadata.tvgName = tvgNameMatch[1];
+  const tvgLogoMatch = attrPart.match(/tvg-logo="([^"]*)"/i);
+  if (tvgLogoMatch) metadata.tvgLogo = tvgLogoMatch[1];
+  const groupTitleMatch = attrPart.match(/group-title="([^"]*)"/i);
+  if (groupTitleMatch) metadata.groupTitle = groupTitleMatch[1];
+
+  return metadata;
+}
+
+// ===========================================================================
+// Fixture
+// ===========================================================================
+
+// Every third entry carries catchup / channel number attributes
+function generatePlaylist(count: number): string {
+  const parts: string[] = ['#EXTM3U url-tvg="http://epg.example/guide.xml.gz"\n'];
+  for (let i = 0; i < count; i++) {
+    const group = `Group ${i % 400}`;
+    const extra = i % 3 === 0 ? ` tvg-chno="${i}" catchup="default" catchup-days="7" tvg-shift="0"` : '';
+    parts.push(
+      `#EXTINF:-1 tvg-id="ch${i}.bench" tvg-name="Channel ${i}" tvg-logo="http://logos.example/${i}.png" ` +
+      `group-title="${group}"${extra},Channel ${i} HD\n` +
+      `http://streams.example/live/user/pass/${i}.ts\n`
+    );
+  }
+  return parts.join('');
+}
+
+// ===========================================================================
+// Runner
+// ===========================================================================
+
+function measure(label: string, lines: number, fn: () => number): void {
+  const times: number[] = [];
+  let count = 0;
+
+  for (let run = 0; run < RUNS; run++) {
+    const t0 = performance.now();
+    count = fn();
+    times.push(performance.now() - t0);
+  }
+
+  const best = Math.min(...times);
+  const linesPerSec = lines / (best / 1000);
+  console.log(
+    `${label.padEnd(10)} ${best.toFixed(0).padStart(6)} ms  ` +
+    `${Math.round(linesPerSec).toLocaleString().padStart(12)} lines/s  (${count} parsed)`
+  );
+}
+
+const playlist = generatePlaylist(ENTRY_COUNT);
+const extinfLines = playlist.split('\n').filter((line) => line.startsWith('#EXTINF:'));
+console.log(
+  `M3U fixture: ${ENTRY_COUNT.toLocaleString()} entries, ` +
+  `${(Buffer.byteLength(playlist) / 1024 / 1024).toFixed(1)} MB\n`
+);
+
+console.log('#EXTINF lines');
+measure('regex', extinfLines.length, () => {
+  let count = 0;
+  for (const line of extinfLines) if (parseExtInfRegex(line).tvgId) count++;
+  return count;
+});
+measure('regex+all', extinfLines.length, () => {
+  let count = 0;
+  for (const line of extinfLines) if (parseExtInfRegexAll(line).tvgId) count++;
+  return count;
+});
+measure('scanner', extinfLines.length, () => {
+  let count = 0;
+  for (const line of extinfLines) if (parseExtInf(line).tvgId) count++;
+  return count;
+});
+
+console.log('\nFull playlist (streaming parser)');
+const totalLines = ENTRY_COUNT * 2 + 1;
+measure('streaming', totalLines, () => {
+  const parser = new M3UStreamParser('bench');
+  let count = 0;
+  for (let i = 0; i < playlist.length; i += CHUNK_SIZE) {
+    parser.push(playlist.substring(i, i + CHUNK_SIZE));
+    count += parser.drain().channels.length;
+  }
+  return count + parser.end().channels.length;
+});
@@ -0,0 +1,158 @@
+/**
+ * XMLTV parser throughput benchmark
+ *
+ * Compares the original whole-document regex parser against the streaming
+ * tokenizer on a generated guide. The streaming parser is fed 64 KB chunks,
+ * the way it consumes a network body.
+ *
+ * Run: pnpm --filter @sbtltv/local-adapter bench:xmltv [programmeCount]
+ */
+
+import { XmltvStreamParser, type XmltvProgram } from '../src/xmltv-parser';
+
+const PROGRAMME_COUNT = Number(process.argv[2]) || 200_000;
+const CHUNK_SIZE = 64 * 1024;
+const RUNS = 3;
+
+// ===========================================================================
+// Baseline: regex parser as previously implemented in XtreamClient
+// ===========================================================================
+
+function parseXmltvRegex(xml: string): XmltvProgram[] {
+  const programs: XmltvProgram[] = [];
+
+  const programPattern = /<programme\s+([^>]+)>([\s\S]*?)<\/programme>/gi;
+  const startAttr = /start="([^"]+)"/;
+  const stopAttr = /stop="([^"]+)"/;
+  const channelAttr = /channel="([^"]+)"/;
+  const titlePattern = /<title[^>]*>([^<]*)<\/title>/i;
+  const descPattern = /<desc[^>]*>([^<]*)<\/desc>/i;
+
+  let match;
+  while ((match = programPattern.exec(xml)) !== null) {
+    const [, attrs, content] = match;
+
+    const startMatch = attrs.match(startAttr);
+    const stopMatch = attrs.match(stopAttr);
+    const channelMatch = attrs.match(channelAttr);
+
+    if (!startMatch || !stopMatch || !channelMatch) continue;
+
+    const titleMatch = content.match(titlePattern);
+    const descMatch = content.match(descPattern);
+
+    const title = titleMatch ? decodeEntitiesRegex(titleMatch[1]) : '';
+    const desc = descMatch ? decodeEntitiesRegex(descMatch[1]) : '';
+
+    const start = parseDateRegex(startMatch[1]);
+    const stop = parseDateRegex(stopMatch[1]);
+
+    if (start && stop && title) {
+      programs.push({ channel_id: channelMatch[1], title, description: desc, start, stop });
+    }
+  }
+
+  return programs;
+}
+
+function parseDateRegex(dateStr: string): Date | null {
+  const match = dateStr.match(/^(\d{4})(\d{2})(\d{2})(\d{2})(\d{2})(\d{2})\s*([+-]\d{4})?$/);
+  if (!match) return null;
+
+  const [, year, month, day, hour, min, sec, tz] = match;
+  const isoStr = `${year}-${month}-${day}T${hour}:${min}:${sec}${tz ? tz.slice(0, 3) + ':' + tz.slice(3) : 'Z'}`;
+  return new Date(isoStr);
+}
+
+function decodeEntitiesRegex(str: string): string {
+  return str
+    .replace(/&amp;/g, '&')
+    .replace(/&lt;/g, '<')
+    .replace(/&gt;/g, '>')
+    .replace(/&quot;/g, '"')
+    .replace(/&apos;/g, "'")
+    .replace(/&#(\d+);/g, (_, code) => String.fromCharCode(parseInt(code, 10)));
+}
+
+// ===========================================================================
+// Fixture
+// ===========================================================================
+
+function pad(n: number): string {
+  return n < 10 ? `0${n}` : String(n);
+}
+
+function xmltvDate(ms: number): string {
+  const d = new Date(ms);
+  return `${d.getUTCFullYear()}${pad(d.getUTCMonth() + 1)}${pad(d.getUTCDate())}${pad(d.getUTCHours())}${pad(d.getUTCMinutes())}00 +0000`;
+}
+
+function generateGuide(count: number): string {
+  const channels = Math.max(1, Math.floor(count / 150));
+  const parts: string[] = ['<?xml version="1.0" encoding="UTF-8"?>\n<tv generator-info-name="bench">\n'];
+
+  for (let c = 0; c < channels; c++) {
+    parts.push(`  <channel id="ch${c}.bench"><display-name>Channel ${c}</display-name><icon src="http://logos.example/${c}.png"/></channel>\n`);
+  }
+
+  const base = Date.UTC(2024, 0, 1);
+  for (let i = 0; i < count; i++) {
+    const channel = i % channels;
+    const slot = Math.floor(i / channels);
+    const start = base + slot * 30 * 60000;
+    parts.push(
+      `  <programme start="${xmltvDate(start)}" stop="${xmltvDate(start + 30 * 60000)}" channel="ch${channel}.bench">\n` +
+      `    <title lang="en">Programme ${i} &amp; Friends</title>\n` +
+      `    <desc lang="en">Episode ${slot} of a long running show on channel ${channel}. Lorem ipsum dolor sit amet, consectetur adipiscing elit.</desc>\n` +
+      `    <category lang="en">Entertainment</category>\n` +
+      `  </programme>\n`
+    );
+  }
+
+  parts.push('</tv>\n');
+  return parts.join('');
+}
+
+// ===========================================================================
+// Runner
+// ===========================================================================
+
+function measure(label: string, bytes: number, fn: () => number): void {
+  const times: number[] = [];
+  let count = 0;
+  let heapPeak = 0;
+
+  for (let run = 0; run < RUNS; run++) {
+    const heapBefore = process.memoryUsage().heapUsed;
+    const t0 = performance.now();
+    count = fn();
+    times.push(performance.now() - t0);
+    heapPeak = Math.max(heapPeak, process.memoryUsage().heapUsed - heapBefore);
+  }
+
+  const best = Math.min(...times);
+  const mbPerSec = bytes / 1024 / 1024 / (best / 1000);
+  const progPerSec = count / (best / 1000);
+  console.log(
+    `${label.padEnd(10)} ${best.toFixed(0).padStart(6)} ms  ${mbPerSec.toFixed(1).padStart(7)} MB/s  ` +
+    `${Math.round(progPerSec).toLocaleString().padStart(11)} programmes/s  ` +
+    `heap +${(heapPeak / 1024 / 1024).toFixed(0)} MB  (${count} parsed)`
+  );
+}
+
+const xml = generateGuide(PROGRAMME_COUNT);
+const bytes = Buffer.byteLength(xml);
+console.log(`XMLTV fixture: ${PROGRAMME_COUNT.toLocaleString()} programmes, ${(bytes / 1024 / 1024).toFixed(1)} MB\n`);
+
+measure('regex', bytes, () => parseXmltvRegex(xml).length);
+
+measure('streaming', bytes, () => {
+  const parser = new XmltvStreamParser();
+  let count = 0;
+  for (let i = 0; i < xml.length; i += CHUNK_SIZE) {
+    parser.push(xml.substring(i, i + CHUNK_SIZE));
+    // Drain like the sync loop does so retained programmes stay bounded
+    count += parser.drain().length;
+  }
+  return count + parser.end().length;
+});
@@ -0,0 +1,32 @@
+/**
+ * Bounded-concurrency helpers
+ */
+
+/**
+ * Run `fn` over `items` with at most `limit` calls in flight.
+ * Never rejects: each item's outcome is reported in input order, so one
+ * failing item doesn't abort (or hide the results of) the others.
+ */
+export async function mapWithConcurrency<T, R>(
+  items: readonly T[],
+  limit: number,
+  fn: (item: T, index: number) => Promise<R>
+): Promise<PromiseSettledResult<R>[]> {
+  const results = new Array<PromiseSettledResult<R>>(items.length);
+  let next = 0;
+
+  async function runNext(): Promise<void> {
+    while (next < items.length) {
+      const index = next++;
+      try {
+        results[index] = { status: 'fulfilled', value: await fn(items[index], index) };
+      } catch (reason) {
+        results[index] = { status: 'rejected', reason };
+      }
+    }
+  }
+
+  const runners = Array.from({ length: Math.max(1, Math.min(limit, items.length)) }, runNext);
+  await Promise.all(runners);
+  return results;
+}
@@ -0,0 +1,244 @@
+/**
+ * HTTP helpers shared by the M3U and Xtream clients
+ *
+ * Prefers Electron's fetch proxy (bypasses CORS + SSRF protection) and falls
+ * back to regular fetch (Node.js or when CORS is not an issue).
+ */
+
+import type { FetchJsonArrayMessage, FetchStreamMessage } from './types/electron';
+
+type FetchProxy = NonNullable<Window['fetchProxy']>;
+
+/**
+ * Electron's fetch proxy for the current global scope.
+ * Looked up on globalThis rather than window so Web Workers can install a
+ * relay that forwards requests to the renderer's preload bridge.
+ */
+export function getFetchProxy(): FetchProxy | undefined {
+  return (globalThis as unknown as { fetchProxy?: FetchProxy }).fetchProxy;
+}
+
+// Cache validators of a remote resource (from a HEAD request)
+export interface ResourceValidators {
+  etag?: string;
+  lastModified?: string;
+}
+
+/**
+ * HEAD a URL and return its ETag / Last-Modified headers.
+ * Returns null when the server rejects HEAD or sends neither header,
+ * in which case callers cannot tell whether the resource changed.
+ */
+export async function fetchResourceValidators(url: string): Promise<ResourceValidators | null> {
+  let headers: Record<string, string> | undefined;
+  const fetchProxy = getFetchProxy();
+  if (fetchProxy) {
+    const result = await fetchProxy.fetch(url, { method: 'HEAD' });
+    if (!result.success || !result.data?.ok) return null;
+    headers = result.data.headers;
+  } else {
+    const response = await fetch(url, { method: 'HEAD' });
+    if (!response.ok) return null;
+    headers = Object.fromEntries(response.headers.entries());
+  }
+
+  const etag = headers?.['etag'];
+  const lastModified = headers?.['last-modified'];
+  if (!etag && !lastModified) return null;
+  return { etag, lastModified };
+}
+
+// Slice size used when a body is already fully in memory
+const BYTE_CHUNK_SIZE = 64 * 1024;
+// Chunks buffered ahead of a fetchStream consumer before acks are held back
+const STREAM_QUEUE_CHUNKS = 4;
+
+/**
+ * Fetch a URL and yield its body as text chunks.
+ * Bodies are decoded as they arrive; gzip payloads (e.g. .xml.gz guides) are
+ * detected by their magic bytes and decompressed in the same pass, so the
+ * decompressed text is never held in memory as a whole.
+ */
+export async function* fetchTextChunks(url: string, label: string): AsyncGenerator<string> {
+  const body = await fetchByteStream(url, label);
+  const reader = (await gunzipIfNeeded(body)).pipeThrough(new TextDecoderStream()).getReader();
+  try {
+    while (true) {
+      const { done, value } = await reader.read();
+      if (done) break;
+      yield value;
+    }
+  } finally {
+    // Stops the download if the consumer bails out early
+    reader.cancel().catch(() => {});
+  }
+}
+
+/**
+ * Fetch a URL as a byte stream.
+ * With the streaming fetch proxy the body arrives chunk by chunk over a
+ * MessagePort; older proxies return the whole body at once, which is
+ * re-chunked here so every path feeds the decoders the same way.
+ * Cancelling the stream stops the download.
+ */
+export async function fetchByteStream(url: string, label: string): Promise<ReadableStream<Uint8Array>> {
+  const fetchProxy = getFetchProxy();
+  if (fetchProxy?.fetchStream) {
+    const streamId = crypto.randomUUID();
+    const portMessage = waitForStreamPort(streamId);
+    const result = await fetchProxy.fetchStream(streamId, url);
+    if (!result.success || !result.data) {
+      portMessage.dispose();
+      throw new Error(result.error || `Failed to fetch ${label}`);
+    }
+    const body = portStream(await portMessage.port);
+    if (!result.data.ok) {
+      body.cancel().catch(() => {});
+      throw new Error(`Failed to fetch ${label}: ${result.data.status} ${result.data.statusText}`);
+    }
+    return body;
+  }
+
+  if (fetchProxy) {
+    const result = await fetchProxy.fetch(url, { responseType: 'arraybuffer' });
+    if (!result.success || !result.data) {
+      throw new Error(result.error || `Failed to fetch ${label}`);
+    }
+    if (!result.data.ok) {
+      throw new Error(`Failed to fetch ${label}: ${result.data.status} ${result.data.statusText}`);
+    }
+    return sliceBytes(result.data.body ?? new TextEncoder().encode(result.data.text));
+  }
+
+  const response = await fetch(url);
+  if (!response.ok) {
+    throw new Error(`Failed to fetch ${label}: ${response.status} ${response.statusText}`);
+  }
+  return response.body ?? sliceBytes(new Uint8Array(await response.arrayBuffer()));
+}
+
+/**
+ * Wait for the port of a fetchStream request. The preload bridge relays it
+ * as a window message; in a worker the renderer forwards the same message.
+ * Listening starts before the request is made since the port can arrive
+ * before the response.
+ */
+export function waitForStreamPort(streamId: string): { port: Promise<MessagePort>; dispose: () => void } {
+  let onMessage: (event: MessageEvent) => void = () => {};
+  const dispose = () => globalThis.removeEventListener('message', onMessage as EventListener);
+  const port = new Promise<MessagePort>((resolve) => {
+    onMessage = (event: MessageEvent) => {
+      if (event.data?.type !== 'fetch-stream-port' || event.data.streamId !== streamId || !event.ports[0]) return;
+      dispose();
+      resolve(event.ports[0]);
+    };
+    globalThis.addEventListener('message', onMessage as EventListener);
+  });
+  return { port, dispose };
+}
+
+// Wrap a fetchStream port in a ReadableStream. Chunks are acknowledged while
+// the consumer keeps up, otherwise when it pulls again (back-pressure).
+function portStream(port: MessagePort): ReadableStream<Uint8Array> {
+  let owedAcks = 0;
+  return new ReadableStream<Uint8Array>({
+    start(controller) {
+      port.onmessage = (event: MessageEvent<FetchStreamMessage>) => {
+        const message = event.data;
+        switch (message.type) {
+          case 'chunk':
+            controller.enqueue(message.data);
+            if ((controller.desiredSize ?? 0) > 0) port.postMessage({ type: 'ack' });
+            else owedAcks++;
+            break;
+          case 'end':
+            port.close();
+            controller.close();
+            break;
+          case 'error':
+            port.close();
+            controller.error(new Error(message.error));
+            break;
+        }
+      };
+    },
+    pull() {
+      for (; owedAcks > 0; owedAcks--) port.postMessage({ type: 'ack' });
+    },
+    cancel() {
+      port.postMessage({ type: 'cancel' });
+      port.close();
+    },
+  }, { highWaterMark: STREAM_QUEUE_CHUNKS });
+}
+
+/**
+ * Collect the elements sent over a fetchJsonArray port. Each batch is
+ * acknowledged once it has been appended.
+ */
+export function readJsonArrayPort(port: MessagePort): Promise<unknown[]> {
+  const items: unknown[] = [];
+  return new Promise((resolve, reject) => {
+    port.onmessage = (event: MessageEvent<FetchJsonArrayMessage>) => {
+      const message = event.data;
+      switch (message.type) {
+        case 'items':
+          for (const item of message.items) items.push(item);
+          port.postMessage({ type: 'ack' });
+          break;
+        case 'end':
+          port.close();
+          resolve(items);
+          break;
+        case 'error':
+          port.close();
+          reject(new Error(message.error));
+          break;
+      }
+    };
+  });
+}
+
+function sliceBytes(bytes: Uint8Array): ReadableStream<Uint8Array> {
+  let offset = 0;
+  return new ReadableStream<Uint8Array>({
+    pull(controller) {
+      if (offset >= bytes.length) {
+        controller.close();
+        return;
+      }
+      controller.enqueue(bytes.subarray(offset, offset + BYTE_CHUNK_SIZE));
+      offset += BYTE_CHUNK_SIZE;
+    },
+  });
+}
+
+/**
+ * Pipe a stream through gzip decompression if it starts with the gzip magic
+ * bytes (1f 8b). Servers often send .gz files without Content-Encoding, so
+ * the transport never decompresses them for us.
+ */
+async function gunzipIfNeeded(stream: ReadableStream<Uint8Array>): Promise<ReadableStream<Uint8Array>> {
+  const reader = stream.getReader();
+  const first = await reader.read();
+
+  // Re-assemble the stream with the peeked chunk in front
+  const replay = new ReadableStream<Uint8Array>({
+    start(controller) {
+      if (first.done) controller.close();
+      else controller.enqueue(first.value);
+    },
+    async pull(controller) {
+      const { done, value } = await reader.read();
+      if (done) controller.close();
+      else controller.enqueue(value);
+    },
+    cancel(reason) {
+      return reader.cancel(reason);
+    },
+  });
+
+  const head = first.value;
+  const isGzip = !!head && head.length >= 2 && head[0] === 0x1f && head[1] === 0x8b;
+  return isGzip ? replay.pipeThrough(new DecompressionStream('gzip')) : replay;
+}
@@ -1,6 +1,6 @@
 // M3U Parser
-export { parseM3U, fetchAndParseM3U } from './m3u-parser';
-export type { M3UParseResult } from './m3u-parser';
+export { parseM3U, fetchAndParseM3U, parseM3UStream, fetchM3UBatches, M3UStreamParser, parseExtInf, DEFAULT_M3U_BATCH_SIZE } from './m3u-parser';
+export type { M3UParseResult, M3UBatch, ExtInfMetadata } from './m3u-parser';
 
 // Xtream Client
 export { XtreamClient } from './xtream-client';
@@ -11,3 +11,16 @@ export type {
   XtreamAuthResponse,
   XmltvProgram,
 } from './xtream-client';
+
+// Per-source client registry
+export { getXtreamClient, invalidateXtreamClient } from './xtream-registry';
+
+// XMLTV Parser
+export { XmltvStreamParser, parseXmltvStream, parseXmltvDate, DEFAULT_XMLTV_BATCH_SIZE } from './xmltv-parser';
+
+// HTTP
+export { fetchTextChunks, fetchByteStream, fetchResourceValidators, getFetchProxy, waitForStreamPort } from './http';
+export type { ResourceValidators } from './http';
+
+// Concurrency
+export { mapWithConcurrency } from './concurrency';
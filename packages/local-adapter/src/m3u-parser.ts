@@ -11,6 +11,7 @@
  */
 
 import type { Channel, Category } from '@sbtltv/core';
+import { fetchTextChunks } from './http';
 
 export interface M3UParseResult {
   channels: Channel[];
@@ -18,85 +19,213 @@ export interface M3UParseResult {
   epgUrl: string | null;
 }
 
-interface ExtInfMetadata {
+// One batch from the streaming parser. Categories are only included in the
+// batch where they first appear; epgUrl is the header value (known from the
+// first batch on).
+export type M3UBatch = M3UParseResult;
+
+export interface ExtInfMetadata {
   duration: number;
   tvgId: string;
   tvgName: string;
   tvgLogo: string;
   groupTitle: string;
   displayName: string;
+  attributes?: Record<string, string>; // Every other attribute (tvg-chno, catchup, ...)
 }
 
+// Default number of channels per emitted batch
+export const DEFAULT_M3U_BATCH_SIZE = 2000;
+
 /**
- * Parse an M3U playlist content
+ * Push-based M3U parser.
+ *
+ * Feed text with push(), collect completed channels with drain().
+ * Channels are only held until drained, but two sets grow with the whole
+ * playlist: the category ids already emitted and the stream ids handed out
+ * (to number duplicate URL / tvg-id pairs). The latter is one short string
+ * per channel - a few MB for a 100k-channel playlist, against the hundreds
+ * of MB the channel objects and playlist text would take.
  */
-export function parseM3U(content: string, sourceId: string): M3UParseResult {
-  const lines = content.split('\n').map(line => line.trim());
-  const channels: Channel[] = [];
-  const categoriesMap = new Map<string, Category>();
+export class M3UStreamParser {
+  private sourceId: string;
+  private buffer = '';
+  private pendingChannels: Channel[] = [];
+  private pendingCategories: Category[] = [];
+  private seenCategories = new Set<string>();
+  private seenStreamIds = new Set<string>(); // Every stream id so far (see above)
+  private currentMetadata: ExtInfMetadata | null = null;
+  private channelCounter = 0;
+  private headerEpgUrl: string | null = null;
+
+  constructor(sourceId: string) {
+    this.sourceId = sourceId;
+  }
 
-  let epgUrl: string | null = null;
-  let currentMetadata: ExtInfMetadata | null = null;
-  let channelCounter = 0;
+  get count(): number {
+    return this.channelCounter;
+  }
 
-  for (let i = 0; i < lines.length; i++) {
-    const line = lines[i];
+  get pendingCount(): number {
+    return this.pendingChannels.length;
+  }
+
+  get epgUrl(): string | null {
+    return this.headerEpgUrl;
+  }
 
+  push(chunk: string): void {
+    this.buffer += chunk;
+    let pos = 0;
+    while (true) {
+      const newline = this.buffer.indexOf('\n', pos);
+      if (newline === -1) break;
+      this.parseLine(this.buffer.substring(pos, newline).trim());
+      pos = newline + 1;
+    }
+    this.buffer = pos > 0 ? this.buffer.substring(pos) : this.buffer;
+  }
+
+  /**
+   * Take up to `max` completed channels (all of them by default), together
+   * with the categories first seen since the last drain
+   */
+  drain(max = Infinity): M3UBatch {
+    let channels: Channel[];
+    if (max >= this.pendingChannels.length) {
+      channels = this.pendingChannels;
+      this.pendingChannels = [];
+    } else {
+      channels = this.pendingChannels.splice(0, max);
+    }
+    const categories = this.pendingCategories;
+    this.pendingCategories = [];
+    return { channels, categories, epgUrl: this.headerEpgUrl };
+  }
+
+  /**
+   * Signal end of input - parses the last (unterminated) line and returns
+   * everything not drained yet
+   */
+  end(): M3UBatch {
+    this.parseLine(this.buffer.trim());
+    this.buffer = '';
+    return this.drain();
+  }
+
+  /**
+   * Content-derived channel id: stays the same when the provider reorders
+   * the playlist. Based on the stream URL (tvg-id is often shared by SD/HD
+   * variants); a repeated URL+tvg-id pair gets an occurrence suffix.
+   */
+  private createStreamId(url: string, tvgId: string): string {
+    const base = `${this.sourceId}_${hashString(`${url}\n${tvgId}`)}`;
+    let streamId = base;
+    for (let n = 2; this.seenStreamIds.has(streamId); n++) {
+      streamId = `${base}_${n}`;
+    }
+    this.seenStreamIds.add(streamId);
+    return streamId;
+  }
+
+  private parseLine(line: string): void {
     // Skip empty lines
-    if (!line) continue;
+    if (!line) return;
 
     // Parse header for EPG URL
     if (line.startsWith('#EXTM3U')) {
-      epgUrl = extractEpgUrl(line);
-      continue;
+      this.headerEpgUrl = extractEpgUrl(line);
+      return;
     }
 
     // Parse EXTINF line
     if (line.startsWith('#EXTINF:')) {
-      currentMetadata = parseExtInf(line);
-      continue;
+      this.currentMetadata = parseExtInf(line);
+      return;
     }
 
     // Skip other comments/directives
-    if (line.startsWith('#')) {
-      continue;
-    }
+    if (line.startsWith('#')) return;
 
     // This should be a URL - create channel if we have metadata
-    if (currentMetadata && (line.startsWith('http://') || line.startsWith('https://') || line.startsWith('rtmp://'))) {
-      channelCounter++;
+    const metadata = this.currentMetadata;
+    if (metadata && (line.startsWith('http://') || line.startsWith('https://') || line.startsWith('rtmp://'))) {
+      this.channelCounter++;
 
       // Create category if needed
-      const categoryId = createCategoryId(sourceId, currentMetadata.groupTitle);
-      if (currentMetadata.groupTitle && !categoriesMap.has(categoryId)) {
-        categoriesMap.set(categoryId, {
+      const categoryId = createCategoryId(this.sourceId, metadata.groupTitle);
+      if (metadata.groupTitle && !this.seenCategories.has(categoryId)) {
+        this.seenCategories.add(categoryId);
+        this.pendingCategories.push({
           category_id: categoryId,
-          category_name: currentMetadata.groupTitle,
-          source_id: sourceId,
+          category_name: metadata.groupTitle,
+          source_id: this.sourceId,
         });
       }
 
-      // Create channel
-      const channel: Channel = {
-        stream_id: `${sourceId}_${channelCounter}`,
-        name: currentMetadata.displayName || currentMetadata.tvgName || `Channel ${channelCounter}`,
-        stream_icon: currentMetadata.tvgLogo || '',
-        epg_channel_id: currentMetadata.tvgId || '',
+      this.pendingChannels.push({
+        stream_id: this.createStreamId(line, metadata.tvgId),
+        name: metadata.displayName || metadata.tvgName || `Channel ${this.channelCounter}`,
+        stream_icon: metadata.tvgLogo || '',
+        epg_channel_id: metadata.tvgId || '',
         category_ids: categoryId ? [categoryId] : [],
         direct_url: line,
-        source_id: sourceId,
-      };
+        source_id: this.sourceId,
+        ...channelExtras(metadata.attributes),
+      });
+      this.currentMetadata = null;
+    }
+  }
+}
 
-      channels.push(channel);
-      currentMetadata = null;
+/**
+ * Optional Channel fields derived from the extra EXTINF attributes
+ */
+function channelExtras(attributes: Record<string, string> | undefined): Partial<Channel> {
+  if (!attributes) return {};
+
+  const extras: Partial<Channel> = { m3u_attributes: attributes };
+  const catchup = attributes['catchup'];
+  if (catchup && catchup !== 'no' && attributes['catchup-days'] !== '0') {
+    extras.tv_archive = true;
+  }
+  return extras;
+}
+
+/**
+ * Parse an M3U playlist content
+ */
+export function parseM3U(content: string, sourceId: string): M3UParseResult {
+  const parser = new M3UStreamParser(sourceId);
+  parser.push(content);
+  return parser.end();
+}
+
+/**
+ * Parse an M3U text stream into batches of at most `batchSize` channels
+ */
+export async function* parseM3UStream(
+  chunks: AsyncIterable<string>,
+  sourceId: string,
+  batchSize = DEFAULT_M3U_BATCH_SIZE
+): AsyncGenerator<M3UBatch> {
+  const parser = new M3UStreamParser(sourceId);
+
+  for await (const chunk of chunks) {
+    parser.push(chunk);
+    while (parser.pendingCount >= batchSize) {
+      yield parser.drain(batchSize);
     }
   }
 
-  return {
-    channels,
-    categories: Array.from(categoriesMap.values()),
-    epgUrl,
-  };
+  const rest = parser.end();
+  for (let i = 0; i < rest.channels.length; i += batchSize) {
+    yield {
+      channels: rest.channels.slice(i, i + batchSize),
+      categories: i === 0 ? rest.categories : [],
+      epgUrl: rest.epgUrl,
+    };
+  }
 }
 
 /**
@@ -123,8 +252,12 @@ function extractEpgUrl(line: string): string | null {
  *
  * Format: #EXTINF:duration key="value" key="value"...,Display Name
  * Example: #EXTINF:-1 tvg-id="cnn" tvg-logo="http://..." group-title="News",CNN HD
+ *
+ * Single left-to-right scan: attribute names are lower-cased, values may be
+ * double/single quoted (commas inside quotes are part of the value) or bare.
+ * The display name is everything after the first comma outside quotes.
  */
-function parseExtInf(line: string): ExtInfMetadata {
+export function parseExtInf(line: string): ExtInfMetadata {
   const metadata: ExtInfMetadata = {
     duration: -1,
     tvgId: '',
@@ -134,49 +267,90 @@ function parseExtInf(line: string): ExtInfMetadata {
     displayName: '',
   };
 
-  // Remove #EXTINF: prefix
-  const content = line.substring(8);
+  const len = line.length;
+  let i = 8; // Skip #EXTINF: prefix
 
-  // Split by comma to get display name (everything after last comma)
-  const commaIndex = content.lastIndexOf(',');
-  if (commaIndex !== -1) {
-    metadata.displayName = content.substring(commaIndex + 1).trim();
-  }
+  // Duration (first token)
+  const durationStart = i;
+  while (i < len && !isSpace(line.charCodeAt(i)) && line.charCodeAt(i) !== COMMA) i++;
+  const duration = parseInt(line.substring(durationStart, i), 10);
+  if (!Number.isNaN(duration)) metadata.duration = duration;
 
-  // Parse the part before the comma for attributes
-  const attrPart = commaIndex !== -1 ? content.substring(0, commaIndex) : content;
+  while (i < len) {
+    const c = line.charCodeAt(i);
+    if (isSpace(c)) {
+      i++;
+      continue;
+    }
+    if (c === COMMA) {
+      metadata.displayName = line.substring(i + 1).trim();
+      break;
+    }
 
-  // Extract duration (first number)
-  const durationMatch = attrPart.match(/^(-?\d+)/);
-  if (durationMatch) {
-    metadata.duration = parseInt(durationMatch[1], 10);
-  }
+    // Attribute name (lower-cased only if needed - it almost never is)
+    const keyStart = i;
+    let upper = false;
+    while (i < len) {
+      const k = line.charCodeAt(i);
+      if (k === EQUALS || k === COMMA || isSpace(k)) break;
+      if (k >= 65 && k <= 90) upper = true;
+      i++;
+    }
+    const key = upper ? line.substring(keyStart, i).toLowerCase() : line.substring(keyStart, i);
+    if (line.charCodeAt(i) !== EQUALS) continue; // Bare flag without a value
+
+    // Attribute value
+    i++;
+    let value: string;
+    const quote = line.charCodeAt(i);
+    if (quote === DOUBLE_QUOTE || quote === SINGLE_QUOTE) {
+      const close = line.indexOf(line[i], i + 1);
+      const valueEnd = close === -1 ? len : close;
+      value = line.substring(i + 1, valueEnd);
+      i = valueEnd + 1;
+    } else {
+      const valueStart = i;
+      while (i < len && !isSpace(line.charCodeAt(i)) && line.charCodeAt(i) !== COMMA) i++;
+      value = line.substring(valueStart, i);
+    }
 
-  // Extract tvg-id
-  const tvgIdMatch = attrPart.match(/tvg-id="([^"]*)"/i);
-  if (tvgIdMatch) {
-    metadata.tvgId = tvgIdMatch[1];
+    switch (key) {
+      case 'tvg-id': metadata.tvgId = value; break;
+      case 'tvg-name': metadata.tvgName = value; break;
+      case 'tvg-logo': metadata.tvgLogo = value; break;
+      case 'group-title': metadata.groupTitle = value; break;
+      default:
+        if (key) (metadata.attributes ??= {})[key] = value;
+    }
   }
 
-  // Extract tvg-name
-  const tvgNameMatch = attrPart.match(/tvg-name="([^"]*)"/i);
-  if (tvgNameMatch) {
-    metadata.tvgName = tvgNameMatch[1];
-  }
+  return metadata;
+}
 
-  // Extract tvg-logo
-  const tvgLogoMatch = attrPart.match(/tvg-logo="([^"]*)"/i);
-  if (tvgLogoMatch) {
-    metadata.tvgLogo = tvgLogoMatch[1];
-  }
+const COMMA = 44;
+const EQUALS = 61;
+const DOUBLE_QUOTE = 34;
+const SINGLE_QUOTE = 39;
 
-  // Extract group-title
-  const groupTitleMatch = attrPart.match(/group-title="([^"]*)"/i);
-  if (groupTitleMatch) {
-    metadata.groupTitle = groupTitleMatch[1];
-  }
+function isSpace(c: number): boolean {
+  return c === 32 || c === 9;
+}
 
-  return metadata;
+/**
+ * 53-bit string hash (cyrb53) in base 36. Wide enough that collisions in a
+ * playlist of a million entries are practically impossible.
+ */
+function hashString(str: string): string {
+  let h1 = 0xdeadbeef;
+  let h2 = 0x41c6ce57;
+  for (let i = 0; i < str.length; i++) {
+    const ch = str.charCodeAt(i);
+    h1 = Math.imul(h1 ^ ch, 2654435761);
+    h2 = Math.imul(h2 ^ ch, 1597334677);
+  }
+  h1 = Math.imul(h1 ^ (h1 >>> 16), 2246822507) ^ Math.imul(h2 ^ (h2 >>> 13), 3266489909);
+  h2 = Math.imul(h2 ^ (h2 >>> 16), 2246822507) ^ Math.imul(h1 ^ (h1 >>> 13), 3266489909);
+  return (4294967296 * (2097151 & h2) + (h1 >>> 0)).toString(36);
 }
 
 /**
@@ -194,29 +368,26 @@ function createCategoryId(sourceId: string, groupTitle: string): string {
   return `${sourceId}_${slug}`;
 }
 
+/**
+ * Fetch an M3U playlist and parse it as it downloads, in channel batches
+ */
+export function fetchM3UBatches(
+  url: string,
+  sourceId: string,
+  batchSize = DEFAULT_M3U_BATCH_SIZE
+): AsyncGenerator<M3UBatch> {
+  return parseM3UStream(fetchTextChunks(url, 'M3U'), sourceId, batchSize);
+}
+
 /**
  * Fetch and parse an M3U playlist from URL
  */
 export async function fetchAndParseM3U(url: string, sourceId: string): Promise<M3UParseResult> {
-  // Use Electron's fetch proxy if available (bypasses CORS + SSRF protection)
-  if (typeof window !== 'undefined' && window.fetchProxy) {
-    const result = await window.fetchProxy.fetch(url);
-    if (!result.success || !result.data) {
-      throw new Error(result.error || 'Failed to fetch M3U');
-    }
-    if (!result.data.ok) {
-      throw new Error(`Failed to fetch M3U: ${result.data.status} ${result.data.statusText}`);
-    }
-    return parseM3U(result.data.text, sourceId);
+  const result: M3UParseResult = { channels: [], categories: [], epgUrl: null };
+  for await (const batch of fetchM3UBatches(url, sourceId)) {
+    result.channels.push(...batch.channels);
+    result.categories.push(...batch.categories);
+    result.epgUrl = batch.epgUrl;
   }
-
-  // Fallback to regular fetch (Node.js or when CORS is not an issue)
-  const response = await fetch(url);
-
-  if (!response.ok) {
-    throw new Error(`Failed to fetch M3U: ${response.status} ${response.statusText}`);
-  }
-
-  const content = await response.text();
-  return parseM3U(content, sourceId);
+  return result;
 }
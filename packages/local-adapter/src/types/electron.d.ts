@@ -4,7 +4,9 @@ export interface FetchProxyResponse {
   ok: boolean;
   status: number;
   statusText: string;
-  text: string;
+  text: string;        // Empty when responseType is 'arraybuffer'
+  body?: Uint8Array;   // Raw (undecoded) body when responseType is 'arraybuffer'
+  headers?: Record<string, string>;  // Response headers (lower-case names)
 }
 
 export interface StorageResult<T = void> {
@@ -13,8 +15,49 @@ export interface StorageResult<T = void> {
   data?: T;
 }
 
+// fetchJsonArray response: the status; the elements follow over a MessagePort
+export interface FetchJsonArrayResponse {
+  ok: boolean;
+  status: number;
+  statusText: string;
+}
+
+// fetchStream response: status and headers; the body follows over a MessagePort
+export interface FetchStreamResponse {
+  ok: boolean;
+  status: number;
+  statusText: string;
+  headers: Record<string, string>;  // Response headers (lower-case names)
+}
+
+// Messages on a fetchStream port (main → renderer). The renderer answers
+// each chunk with { type: 'ack' } and can stop the download with { type: 'cancel' }.
+export type FetchStreamMessage =
+  | { type: 'chunk'; data: Uint8Array }
+  | { type: 'end' }
+  | { type: 'error'; error: string };
+
+// Messages on a fetchJsonArray port: the array's elements in batches, parsed
+// while downloading (acknowledged and cancelled like a fetchStream port)
+export type FetchJsonArrayMessage =
+  | { type: 'items'; items: unknown[] }
+  | { type: 'end' }
+  | { type: 'error'; error: string };
+
+export interface FetchProxyOptions {
+  method?: string;
+  headers?: Record<string, string>;
+  body?: string;
+  responseType?: 'text' | 'arraybuffer';
+}
+
 export interface FetchProxyApi {
-  fetch: (url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) => Promise<StorageResult<FetchProxyResponse>>;
+  fetch: (url: string, options?: FetchProxyOptions) => Promise<StorageResult<FetchProxyResponse>>;
+  // Same port relay as fetchStream; no elements arrive when !ok
+  fetchJsonArray: (streamId: string, url: string) => Promise<StorageResult<FetchJsonArrayResponse>>;
+  // Streaming fetch. Resolves once headers arrive; the body is sent over a
+  // MessagePort relayed as a window message { type: 'fetch-stream-port', streamId }.
+  fetchStream: (streamId: string, url: string, options?: FetchProxyOptions) => Promise<StorageResult<FetchStreamResponse>>;
 }
 
 declare global {
@@ -0,0 +1,305 @@
+/**
+ * Streaming XMLTV Parser
+ *
+ * Incremental tokenizer for XMLTV guide data. The document is consumed in
+ * arbitrary text chunks (as they arrive from the network) and <programme>
+ * entries are emitted in bounded batches, so memory stays proportional to the
+ * batch size instead of the guide size.
+ *
+ * XMLTV Format:
+ * <tv>
+ *   <channel id="cnn.us">...</channel>
+ *   <programme start="20240101120000 +0000" stop="20240101130000 +0000" channel="cnn.us">
+ *     <title lang="en">News</title>
+ *     <desc lang="en">Headlines</desc>
+ *   </programme>
+ * </tv>
+ */
+
+// XMLTV program from parsed EPG data
+export interface XmltvProgram {
+  channel_id: string;
+  title: string;
+  description: string;
+  start: Date;
+  stop: Date;
+}
+
+const OPEN_TAG = '<programme';
+const CLOSE_TAG = '</programme>';
+
+// Default number of programmes per emitted batch
+export const DEFAULT_XMLTV_BATCH_SIZE = 500;
+
+// A <programme> element still open after this many characters is treated as
+// malformed and skipped, so a missing close tag can't buffer the rest of the guide
+const MAX_PROGRAMME_LENGTH = 1024 * 1024;
+
+/**
+ * Push-based XMLTV tokenizer.
+ *
+ * Feed text with push(), collect completed programmes with drain().
+ * Only the unfinished tail of the current <programme> element is buffered
+ * between pushes; everything before it (channels, icons, whitespace) is dropped.
+ */
+export class XmltvStreamParser {
+  private buffer = '';
+  private pending: XmltvProgram[] = [];
+  private parsedCount = 0;
+  private skippedCount = 0;
+
+  get count(): number {
+    return this.parsedCount;
+  }
+
+  // Malformed <programme> elements (unclosed, or over MAX_PROGRAMME_LENGTH)
+  get skipped(): number {
+    return this.skippedCount;
+  }
+
+  get pendingCount(): number {
+    return this.pending.length;
+  }
+
+  push(chunk: string): void {
+    this.buffer += chunk;
+    let pos = 0;
+
+    while (true) {
+      const open = this.buffer.indexOf(OPEN_TAG, pos);
+      if (open === -1) {
+        // Keep a possible partial "<programme" at the tail for the next chunk
+        pos = Math.max(pos, this.buffer.length - OPEN_TAG.length);
+        break;
+      }
+
+      const tagEnd = this.buffer.indexOf('>', open);
+      if (tagEnd === -1) {
+        if (this.buffer.length - open > MAX_PROGRAMME_LENGTH) {
+          this.skippedCount++;
+          pos = open + OPEN_TAG.length;
+          continue;
+        }
+        pos = open;
+        break;
+      }
+
+      // Self-closing <programme ... /> has no title, skip it
+      if (this.buffer.charCodeAt(tagEnd - 1) === 47 /* / */) {
+        pos = tagEnd + 1;
+        continue;
+      }
+
+      const close = this.buffer.indexOf(CLOSE_TAG, tagEnd);
+      if (close === -1) {
+        if (this.buffer.length - open > MAX_PROGRAMME_LENGTH) {
+          this.skippedCount++;
+          pos = tagEnd + 1;
+          continue;
+        }
+        pos = open;
+        break;
+      }
+
+      const content = this.buffer.substring(tagEnd + 1, close);
+      // An unclosed <programme> runs into the next one - skip it, keep the next
+      const nested = content.indexOf(OPEN_TAG);
+      if (nested !== -1) {
+        this.skippedCount++;
+        pos = tagEnd + 1 + nested;
+        continue;
+      }
+
+      const program = parseProgramme(this.buffer.substring(open + OPEN_TAG.length, tagEnd), content);
+      if (program) {
+        this.pending.push(program);
+        this.parsedCount++;
+      }
+      pos = close + CLOSE_TAG.length;
+    }
+
+    this.buffer = pos > 0 ? this.buffer.substring(pos) : this.buffer;
+  }
+
+  /**
+   * Take up to `max` completed programmes (all of them by default)
+   */
+  drain(max = Infinity): XmltvProgram[] {
+    if (max >= this.pending.length) {
+      const out = this.pending;
+      this.pending = [];
+      return out;
+    }
+    return this.pending.splice(0, max);
+  }
+
+  /**
+   * Signal end of input - returns remaining programmes and resets state
+   */
+  end(): XmltvProgram[] {
+    this.buffer = '';
+    return this.drain();
+  }
+}
+
+/**
+ * Parse an XMLTV text stream into batches of at most `batchSize` programmes
+ */
+export async function* parseXmltvStream(
+  chunks: AsyncIterable<string>,
+  batchSize = DEFAULT_XMLTV_BATCH_SIZE
+): AsyncGenerator<XmltvProgram[]> {
+  const parser = new XmltvStreamParser();
+
+  for await (const chunk of chunks) {
+    parser.push(chunk);
+    while (parser.pendingCount >= batchSize) {
+      yield parser.drain(batchSize);
+    }
+  }
+
+  const rest = parser.end();
+  for (let i = 0; i < rest.length; i += batchSize) {
+    yield rest.slice(i, i + batchSize);
+  }
+}
+
+// ===========================================================================
+// Element Parsing
+// ===========================================================================
+
+function parseProgramme(attrs: string, content: string): XmltvProgram | null {
+  const startStr = readAttribute(attrs, 'start');
+  const stopStr = readAttribute(attrs, 'stop');
+  const channelId = readAttribute(attrs, 'channel');
+  if (!startStr || !stopStr || !channelId) return null;
+
+  const title = readElementText(content, 'title');
+  if (!title) return null;
+
+  const start = parseXmltvDate(startStr);
+  const stop = parseXmltvDate(stopStr);
+  if (!start || !stop) return null;
+
+  return {
+    channel_id: decodeXmlEntities(channelId),
+    title,
+    description: readElementText(content, 'desc'),
+    start,
+    stop,
+  };
+}
+
+/**
+ * Read a quoted attribute value (attribute order varies between providers)
+ */
+function readAttribute(attrs: string, name: string): string | null {
+  let from = 0;
+  while (true) {
+    const idx = attrs.indexOf(name, from);
+    if (idx === -1) return null;
+    from = idx + name.length;
+
+    // Must be a whole attribute name: preceded by whitespace, followed by =
+    const before = idx === 0 ? 32 : attrs.charCodeAt(idx - 1);
+    if (before !== 32 && before !== 9 && before !== 10 && before !== 13) continue;
+
+    let i = from;
+    while (attrs.charCodeAt(i) === 32) i++;
+    if (attrs[i] !== '=') continue;
+    i++;
+    while (attrs.charCodeAt(i) === 32) i++;
+
+    const quote = attrs[i];
+    if (quote !== '"' && quote !== "'") continue;
+    const end = attrs.indexOf(quote, i + 1);
+    if (end === -1) return null;
+    return attrs.substring(i + 1, end);
+  }
+}
+
+/**
+ * Read the text of the first child element with the given tag name
+ */
+function readElementText(content: string, tag: string): string {
+  let open = -1;
+  let textStart = -1;
+  for (let from = 0; ; from = open + 1) {
+    open = content.indexOf(`<${tag}`, from);
+    if (open === -1) return '';
+
+    // Skip longer tag names sharing the prefix (e.g. <titles>, <title-alt>)
+    const next = content.charCodeAt(open + tag.length + 1);
+    if (next !== 62 /* > */ && next !== 47 /* / */ && next !== 32 && next !== 9 && next !== 10 && next !== 13) continue;
+
+    textStart = content.indexOf('>', open);
+    if (textStart === -1) return '';
+    // Skip empty <title/> in favour of a later one with text
+    if (content.charCodeAt(textStart - 1) === 47 /* / */) continue;
+    break;
+  }
+
+  const textEnd = content.indexOf(`</${tag}>`, textStart);
+  if (textEnd === -1) return '';
+
+  const raw = content.substring(textStart + 1, textEnd);
+  if (raw.startsWith('<![CDATA[') && raw.endsWith(']]>')) {
+    return raw.substring(9, raw.length - 3);
+  }
+  return decodeXmlEntities(raw);
+}
+
+/**
+ * Parse XMLTV date format: YYYYMMDDHHmmss +0000 (timezone optional, defaults to UTC)
+ */
+export function parseXmltvDate(dateStr: string): Date | null {
+  if (dateStr.length < 14) return null;
+
+  const year = readDigits(dateStr, 0, 4);
+  const month = readDigits(dateStr, 4, 2);
+  const day = readDigits(dateStr, 6, 2);
+  const hour = readDigits(dateStr, 8, 2);
+  const min = readDigits(dateStr, 10, 2);
+  const sec = readDigits(dateStr, 12, 2);
+  if (year < 0 || month < 0 || day < 0 || hour < 0 || min < 0 || sec < 0) return null;
+
+  let offsetMinutes = 0;
+  let i = 14;
+  while (dateStr.charCodeAt(i) === 32) i++;
+  if (i < dateStr.length) {
+    const sign = dateStr[i];
+    if ((sign !== '+' && sign !== '-') || dateStr.length - i !== 5) return null;
+    const tzHours = readDigits(dateStr, i + 1, 2);
+    const tzMins = readDigits(dateStr, i + 3, 2);
+    if (tzHours < 0 || tzMins < 0) return null;
+    offsetMinutes = (tzHours * 60 + tzMins) * (sign === '-' ? -1 : 1);
+  }
+
+  return new Date(Date.UTC(year, month - 1, day, hour, min, sec) - offsetMinutes * 60000);
+}
+
+function readDigits(str: string, start: number, length: number): number {
+  let value = 0;
+  for (let i = start; i < start + length; i++) {
+    const code = str.charCodeAt(i) - 48;
+    if (code < 0 || code > 9) return -1;
+    value = value * 10 + code;
+  }
+  return value;
+}
+
+export function decodeXmlEntities(str: string): string {
+  if (str.indexOf('&') === -1) return str;
+  return str
+    .replace(/&#x([0-9a-f]+);/gi, (_, code) => fromCodePoint(parseInt(code, 16)))
+    .replace(/&#(\d+);/g, (_, code) => fromCodePoint(parseInt(code, 10)))
+    .replace(/&lt;/g, '<')
+    .replace(/&gt;/g, '>')
+    .replace(/&quot;/g, '"')
+    .replace(/&apos;/g, "'")
+    .replace(/&amp;/g, '&');
+}
+
+function fromCodePoint(code: number): string {
+  return code > 0 && code <= 0x10ffff ? String.fromCodePoint(code) : '';
+}
@@ -11,6 +11,10 @@
  */
 
 import type { Channel, Category, Movie, Series, Season } from '@sbtltv/core';
+import { getFetchProxy, readJsonArrayPort, waitForStreamPort } from './http';
+import type { XmltvProgram } from './xmltv-parser';
+
+export type { XmltvProgram } from './xmltv-parser';
 
 export interface XtreamConfig {
   baseUrl: string;
@@ -47,9 +51,15 @@ export interface XtreamAuthResponse {
   server_info: XtreamServerInfo;
 }
 
+// How long a successful authentication (player_api.php) response is reused
+const AUTH_CACHE_TTL_MS = 10 * 60 * 1000;
+
 export class XtreamClient {
   private config: XtreamConfig;
   private sourceId: string;
+  private auth: { info: XtreamAuthResponse; fetchedAt: number } | null = null;
+  private authRequest: Promise<XtreamAuthResponse> | null = null;
+  private clockSkewMs = 0;
 
   constructor(config: XtreamConfig, sourceId: string) {
     // Normalize base URL (remove trailing slash)
@@ -73,10 +83,41 @@ export class XtreamClient {
     return url;
   }
 
+  /**
+   * Fetch an endpoint that returns a JSON array (catalog listings).
+   * Through the fetch proxy the array is parsed incrementally in the main
+   * process and its elements arrive in batches over a MessagePort - the
+   * (often huge) response text is never materialised as one string, and the
+   * array never crosses IPC as one message.
+   */
+  private async fetchJsonArray<T>(url: string): Promise<T[]> {
+    const fetchProxy = getFetchProxy();
+    if (!fetchProxy?.fetchJsonArray) {
+      const data = await this.fetchJson<T[]>(url);
+      if (!Array.isArray(data)) throw new Error('Xtream API error: expected a JSON array');
+      return data;
+    }
+
+    const streamId = crypto.randomUUID();
+    const portMessage = waitForStreamPort(streamId);
+    const result = await fetchProxy.fetchJsonArray(streamId, url);
+    if (!result.success || !result.data) {
+      portMessage.dispose();
+      throw new Error(result.error || 'Fetch failed');
+    }
+    const items = readJsonArrayPort(await portMessage.port);
+    if (!result.data.ok) {
+      items.catch(() => {});
+      throw new Error(`Xtream API error: ${result.data.status} ${result.data.statusText}`);
+    }
+    return (await items) as T[];
+  }
+
   private async fetchJson<T>(url: string): Promise<T> {
     // Use Electron's fetch proxy if available (bypasses CORS)
-    if (typeof window !== 'undefined' && window.fetchProxy) {
-      const result = await window.fetchProxy.fetch(url);
+    const fetchProxy = getFetchProxy();
+    if (fetchProxy) {
+      const result = await fetchProxy.fetch(url);
       if (!result.success || !result.data) {
         throw new Error(result.error || 'Fetch failed');
       }
@@ -98,14 +139,59 @@ export class XtreamClient {
   // Authentication
   // ===========================================================================
 
-  async authenticate(): Promise<XtreamAuthResponse> {
-    const url = this.buildApiUrl();
-    return this.fetchJson<XtreamAuthResponse>(url);
+  /**
+   * Account and server info. Successful responses are cached for `maxAgeMs`
+   * (pass 0 to force a round trip); concurrent calls share one request.
+   */
+  async authenticate(maxAgeMs = AUTH_CACHE_TTL_MS): Promise<XtreamAuthResponse> {
+    if (this.auth && Date.now() - this.auth.fetchedAt < maxAgeMs) {
+      return this.auth.info;
+    }
+    if (!this.authRequest) {
+      this.authRequest = this.fetchAuth().finally(() => {
+        this.authRequest = null;
+      });
+    }
+    return this.authRequest;
+  }
+
+  private async fetchAuth(): Promise<XtreamAuthResponse> {
+    const sentAt = Date.now();
+    const info = await this.fetchJson<XtreamAuthResponse>(this.buildApiUrl());
+    const receivedAt = Date.now();
+
+    // Server clock vs ours, assuming the server stamped the response halfway through the round trip
+    const serverNow = Number(info?.server_info?.timestamp_now);
+    if (Number.isFinite(serverNow) && serverNow > 0) {
+      this.clockSkewMs = serverNow * 1000 - (sentAt + receivedAt) / 2;
+    }
+    if (info?.user_info?.auth === 1) {
+      this.auth = { info, fetchedAt: receivedAt };
+    }
+    return info;
+  }
+
+  // Drop the cached authentication response
+  invalidateAuth(): void {
+    this.auth = null;
+  }
+
+  /**
+   * Server clock minus local clock in ms (0 until authenticated).
+   * timestamp_now has one second resolution, so small values are noise.
+   */
+  getClockSkewMs(): number {
+    return this.clockSkewMs;
+  }
+
+  // Current time on the server's clock (ms since epoch)
+  serverNow(): number {
+    return Date.now() + this.clockSkewMs;
   }
 
-  async testConnection(): Promise<{ success: boolean; error?: string; info?: XtreamAuthResponse }> {
+  async testConnection(maxAgeMs = AUTH_CACHE_TTL_MS): Promise<{ success: boolean; error?: string; info?: XtreamAuthResponse }> {
     try {
-      const info = await this.authenticate();
+      const info = await this.authenticate(maxAgeMs);
       if (info.user_info.auth !== 1) {
         return { success: false, error: 'Authentication failed' };
       }
@@ -121,7 +207,7 @@ export class XtreamClient {
 
   async getLiveCategories(): Promise<Category[]> {
     const url = this.buildApiUrl('get_live_categories');
-    const data = await this.fetchJson<XtreamCategory[]>(url);
+    const data = await this.fetchJsonArray<XtreamCategory>(url);
 
     return data.map(cat => ({
       category_id: `${this.sourceId}_${cat.category_id}`,
@@ -138,7 +224,7 @@ export class XtreamClient {
       url += `&category_id=${rawCatId}`;
     }
 
-    const data = await this.fetchJson<XtreamStream[]>(url);
+    const data = await this.fetchJsonArray<XtreamStream>(url);
 
     return data.map(stream => ({
       stream_id: `${this.sourceId}_${stream.stream_id}`,
@@ -158,7 +244,7 @@ export class XtreamClient {
 
   async getVodCategories(): Promise<Category[]> {
     const url = this.buildApiUrl('get_vod_categories');
-    const data = await this.fetchJson<XtreamCategory[]>(url);
+    const data = await this.fetchJsonArray<XtreamCategory>(url);
 
     return data.map(cat => ({
       category_id: `${this.sourceId}_vod_${cat.category_id}`,
@@ -174,7 +260,7 @@ export class XtreamClient {
       url += `&category_id=${rawCatId}`;
     }
 
-    const data = await this.fetchJson<XtreamVodStream[]>(url);
+    const data = await this.fetchJsonArray<XtreamVodStream>(url);
 
     return data.map(vod => ({
       stream_id: `${this.sourceId}_${vod.stream_id}`,
@@ -200,7 +286,7 @@ export class XtreamClient {
 
   async getSeriesCategories(): Promise<Category[]> {
     const url = this.buildApiUrl('get_series_categories');
-    const data = await this.fetchJson<XtreamCategory[]>(url);
+    const data = await this.fetchJsonArray<XtreamCategory>(url);
 
     return data.map(cat => ({
       category_id: `${this.sourceId}_series_${cat.category_id}`,
@@ -216,7 +302,7 @@ export class XtreamClient {
       url += `&category_id=${rawCatId}`;
     }
 
-    const data = await this.fetchJson<XtreamSeries[]>(url);
+    const data = await this.fetchJsonArray<XtreamSeries>(url);
 
     return data.map(series => ({
       series_id: `${this.sourceId}_${series.series_id}`,
@@ -281,96 +367,25 @@ export class XtreamClient {
     return data.epg_listings || [];
   }
 
-  // Fetch full XMLTV EPG data
-  async getXmltvEpg(): Promise<XmltvProgram[]> {
-    const url = this.getEpgUrl();
-
-    // Use fetch proxy if available, otherwise regular fetch
-    let xmlText: string;
-    if (typeof window !== 'undefined' && window.fetchProxy) {
-      const result = await window.fetchProxy.fetch(url);
-      if (!result.success || !result.data) {
-        throw new Error(result.error || 'Failed to fetch XMLTV');
-      }
-      xmlText = result.data.text;
-    } else {
-      const response = await fetch(url);
-      if (!response.ok) {
-        throw new Error(`Failed to fetch XMLTV: ${response.status}`);
-      }
-      xmlText = await response.text();
-    }
-
-    // Parse XMLTV
-    return this.parseXmltv(xmlText);
-  }
-
-  private parseXmltv(xml: string): XmltvProgram[] {
+  // Short EPG normalised to the XMLTV programme shape (titles/descriptions are base64 in the API)
+  async getShortEpgPrograms(streamId: string, limit = 4): Promise<XmltvProgram[]> {
+    const entries = await this.getShortEpg(streamId, limit);
     const programs: XmltvProgram[] = [];
-
-    // More flexible regex - extracts attributes individually since order varies
-    // Matches: <programme ...attributes... >content</programme>
-    const programPattern = /<programme\s+([^>]+)>([\s\S]*?)<\/programme>/gi;
-    const startAttr = /start="([^"]+)"/;
-    const stopAttr = /stop="([^"]+)"/;
-    const channelAttr = /channel="([^"]+)"/;
-    const titlePattern = /<title[^>]*>([^<]*)<\/title>/i;
-    const descPattern = /<desc[^>]*>([^<]*)<\/desc>/i;
-
-    let match;
-    while ((match = programPattern.exec(xml)) !== null) {
-      const [, attrs, content] = match;
-
-      const startMatch = attrs.match(startAttr);
-      const stopMatch = attrs.match(stopAttr);
-      const channelMatch = attrs.match(channelAttr);
-
-      if (!startMatch || !stopMatch || !channelMatch) continue;
-
-      const titleMatch = content.match(titlePattern);
-      const descMatch = content.match(descPattern);
-
-      const title = titleMatch ? this.decodeXmlEntities(titleMatch[1]) : '';
-      const desc = descMatch ? this.decodeXmlEntities(descMatch[1]) : '';
-
-      // Parse XMLTV date format: YYYYMMDDHHmmss +0000
-      const start = this.parseXmltvDate(startMatch[1]);
-      const stop = this.parseXmltvDate(stopMatch[1]);
-
-      if (start && stop && title) {
-        programs.push({
-          channel_id: channelMatch[1],
-          title,
-          description: desc,
-          start,
-          stop,
-        });
-      }
+    for (const entry of entries) {
+      const start = Number(entry.start_timestamp) * 1000;
+      const stop = Number(entry.stop_timestamp) * 1000;
+      if (!Number.isFinite(start) || !Number.isFinite(stop) || stop <= start) continue;
+      programs.push({
+        channel_id: entry.channel_id,
+        title: decodeBase64Text(entry.title),
+        description: decodeBase64Text(entry.description),
+        start: new Date(start),
+        stop: new Date(stop),
+      });
     }
-
     return programs;
   }
 
-  private parseXmltvDate(dateStr: string): Date | null {
-    // Format: YYYYMMDDHHmmss +0000 or YYYYMMDDHHmmss
-    const match = dateStr.match(/^(\d{4})(\d{2})(\d{2})(\d{2})(\d{2})(\d{2})\s*([+-]\d{4})?$/);
-    if (!match) return null;
-
-    const [, year, month, day, hour, min, sec, tz] = match;
-    const isoStr = `${year}-${month}-${day}T${hour}:${min}:${sec}${tz ? tz.slice(0, 3) + ':' + tz.slice(3) : 'Z'}`;
-    return new Date(isoStr);
-  }
-
-  private decodeXmlEntities(str: string): string {
-    return str
-      .replace(/&amp;/g, '&')
-      .replace(/&lt;/g, '<')
-      .replace(/&gt;/g, '>')
-      .replace(/&quot;/g, '"')
-      .replace(/&apos;/g, "'")
-      .replace(/&#(\d+);/g, (_, code) => String.fromCharCode(parseInt(code, 10)));
-  }
-
   // ===========================================================================
   // URL Building
   // ===========================================================================
@@ -457,19 +472,24 @@ interface XtreamEpisode {
 interface XtreamEpgEntry {
   id: string;
   epg_id: string;
-  title: string;
+  title: string;        // base64
   lang: string;
-  start: string;
+  start: string;        // Server-local time, prefer start_timestamp
   end: string;
-  description: string;
+  description: string;  // base64
   channel_id: string;
+  start_timestamp: string;  // Unix seconds
+  stop_timestamp: string;
 }
 
-// XMLTV program from parsed EPG data
-export interface XmltvProgram {
-  channel_id: string;
-  title: string;
-  description: string;
-  start: Date;
-  stop: Date;
+// Decode base64 UTF-8 text; falls back to the raw value for servers that send plain text
+function decodeBase64Text(value: string | undefined): string {
+  if (!value) return '';
+  try {
+    const binary = atob(value);
+    const bytes = Uint8Array.from(binary, (c) => c.charCodeAt(0));
+    return new TextDecoder('utf-8', { fatal: true }).decode(bytes).trim();
+  } catch {
+    return value;
+  }
 }
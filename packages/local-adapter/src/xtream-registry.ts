@@ -0,0 +1,45 @@
+/**
+ * Per-source XtreamClient registry
+ *
+ * Sync stages (live, VOD, series episodes, EPG) share one client per source,
+ * so the cached authentication response and clock skew are reused instead of
+ * re-authenticating for every stage. A client is replaced when the source's
+ * server URL or credentials change.
+ */
+
+import type { Source } from '@sbtltv/core';
+import { XtreamClient } from './xtream-client';
+
+const clients = new Map<string, { key: string; client: XtreamClient }>();
+
+/**
+ * Shared client for an Xtream source, or null if it is not an Xtream source
+ * with credentials
+ */
+export function getXtreamClient(source: Source): XtreamClient | null {
+  if (source.type !== 'xtream' || !source.username || !source.password) {
+    return null;
+  }
+
+  const key = JSON.stringify([source.url, source.username, source.password]);
+  const entry = clients.get(source.id);
+  if (entry?.key === key) return entry.client;
+
+  const client = new XtreamClient(
+    { baseUrl: source.url, username: source.username, password: source.password },
+    source.id
+  );
+  clients.set(source.id, { key, client });
+  return client;
+}
+
+/**
+ * Forget a source's client (or every client), e.g. after the source is deleted
+ */
+export function invalidateXtreamClient(sourceId?: string): void {
+  if (sourceId) {
+    clients.delete(sourceId);
+  } else {
+    clients.clear();
+  }
+}
@@ -0,0 +1,239 @@
+/**
+ * EPG search latency benchmark
+ *
+ * Generates a guide, packs it into blocks and search entries the way
+ * epg-store.ts does, then times queries two ways:
+ * - baseline: every block holding the driving term from yesterday on, read
+ *   a day at a time until `limit` (the search before the in-memory window)
+ * - window: SearchWindow over yesterday, today and tomorrow, plus the later
+ *   days fallback when the window has fewer than `limit` results
+ *
+ * Runs in Node on the same matching code the app uses (epg-search-index.ts).
+ * There is no IndexedDB here, so reads are modelled by decoding rows with
+ * v8.deserialize, the structured clone format IndexedDB stores; index
+ * lookups and transaction overhead are not included. The window load is
+ * reported separately - it happens once per guide change, not per query.
+ *
+ * Run: pnpm --filter @sbtltv/ui bench:epg-search [programmeCount]
+ */
+
+import v8 from 'node:v8';
+import type { EpgSearchEntry, StoredProgramBlock } from '../src/db';
+import { DAY_MS, dayOf, packProgramBlock, type ProgramWithDescription } from '../src/db/program-blocks';
+import { SearchWindow, buildSearchEntry, matchBlocks, tokenize } from '../src/db/epg-search-index';
+
+const PROGRAMME_COUNT = Number(process.argv[2]) || 500_000;
+const RESULT_LIMIT = 50;
+const RUNS = 3;
+const QUERIES = [
+  'ne', 'new', 'news', 'ma', 'sport', 'world ne', 'football match',
+  'news weather', 'zyqx', 'kibaro', 'night mo',
+];
+
+// ===========================================================================
+// Fixture
+// ===========================================================================
+
+// Deterministic LCG so every run builds the same guide
+let seed = 12345;
+function random(): number {
+  seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+  return seed / 0x7fffffff;
+}
+
+// Roughly Zipf-distributed rank in [0, n)
+function zipf(n: number): number {
+  return Math.min(n - 1, Math.floor(Math.exp(random() * Math.log(n + 1)) - 1));
+}
+
+const CONSONANTS = 'bcdfghklmnprstvwjz';
+const VOWELS = 'aeiouy';
+function pick(chars: string): string {
+  return chars[Math.floor(random() * chars.length)];
+}
+
+function syllableWord(): string {
+  let word = '';
+  const syllables = 1 + Math.floor(random() * 3);
+  for (let i = 0; i < syllables; i++) {
+    word += pick(CONSONANTS) + pick(VOWELS);
+    if (random() < 0.4) word += pick(CONSONANTS);
+  }
+  return word;
+}
+
+// Common guide words first so they get the most frequent ranks
+const VOCABULARY = [
+  'news', 'new', 'live', 'world', 'sport', 'match', 'film', 'show', 'series', 'episode',
+  'season', 'football', 'weather', 'night', 'morning', 'network', 'never', 'next',
+  'nature', 'music', 'movie', 'family', 'drama', 'comedy', 'kids', 'cooking', 'travel',
+  'history', 'science',
+];
+while (VOCABULARY.length < 40_000) VOCABULARY.push(syllableWord());
+const FILLER = ['the', 'and', 'of', 'in', 'on', 'with', 'for', 'to', 'a'];
+
+const TITLES = Array.from({ length: 4000 }, () => {
+  const words = 1 + Math.floor(random() * 3);
+  return Array.from({ length: words }, () => VOCABULARY[zipf(3000)]).join(' ');
+});
+
+function description(): string {
+  const words: string[] = [];
+  const count = 15 + Math.floor(random() * 25);
+  for (let i = 0; i < count; i++) {
+    words.push(random() < 0.3 ? FILLER[Math.floor(random() * FILLER.length)] : VOCABULARY[zipf(VOCABULARY.length)]);
+  }
+  return words.join(' ');
+}
+
+interface StoredRows {
+  block: Buffer; // Serialised as IndexedDB would store them
+  entry: Buffer;
+  day: number;
+  terms: string[];
+}
+
+// A week of guide from 12 hours ago, ~52 minute programmes on every channel
+function generateGuide(count: number, now: number): StoredRows[] {
+  const from = now - 12 * 60 * 60 * 1000;
+  const until = from + 7.5 * DAY_MS;
+  const channels = Math.ceil(count / ((until - from) / (52 * 60000)));
+  const rows: StoredRows[] = [];
+  let written = 0;
+
+  for (let c = 0; c < channels && written < count; c++) {
+    const streamId = `bench_ch${c}`;
+    const byDay = new Map<number, ProgramWithDescription[]>();
+    let start = Math.round((from - random() * 60 * 60 * 1000) / 300_000) * 300_000;
+    while (start < until && written < count) {
+      const duration = (15 + 15 * Math.floor(random() * 6)) * 60000;
+      const program: ProgramWithDescription = {
+        stream_id: streamId,
+        title: TITLES[zipf(TITLES.length)],
+        description: description(),
+        start: new Date(start),
+        end: new Date(start + duration),
+        source_id: 'bench',
+      };
+      const day = dayOf(start);
+      const programs = byDay.get(day);
+      if (programs) programs.push(program);
+      else byDay.set(day, [program]);
+      start += duration;
+      written++;
+    }
+    for (const [day, programs] of byDay) {
+      const { block, descriptions } = packProgramBlock(streamId, day, programs);
+      const entry = buildSearchEntry(block, descriptions.descriptions);
+      rows.push({ block: v8.serialize(block), entry: v8.serialize(entry), day, terms: entry.terms });
+    }
+  }
+  return rows;
+}
+
+type Block = { entry: EpgSearchEntry; block: StoredProgramBlock };
+
+function readRows(rows: StoredRows[]): Block[] {
+  return rows.map((row) => ({ entry: v8.deserialize(row.entry), block: v8.deserialize(row.block) }));
+}
+
+// Rows holding the query's driving term after `afterDay`, grouped by day
+// (what the multiEntry `terms` index returns)
+function rowsByDay(rows: StoredRows[], words: string[], prefix: string, afterDay: number): StoredRows[][] {
+  const driver = words.length > 0 ? words.reduce((a, b) => (b.length > a.length ? b : a)) : null;
+  const days = new Map<number, StoredRows[]>();
+  for (const row of rows) {
+    if (row.day <= afterDay) continue;
+    const hit = driver ? row.terms.includes(driver) : row.terms.some((term) => term.startsWith(prefix));
+    if (!hit) continue;
+    const dayRows = days.get(row.day);
+    if (dayRows) dayRows.push(row);
+    else days.set(row.day, [row]);
+  }
+  return [...days.keys()].sort((a, b) => a - b).map((day) => days.get(day)!);
+}
+
+// Read and match a day at a time until `limit`; returns ids and rows read
+function searchDays(days: StoredRows[][], words: string[], prefix: string, now: number, limit: number) {
+  const ids: string[] = [];
+  let read = 0;
+  for (const dayRows of days) {
+    read += dayRows.length;
+    ids.push(...matchBlocks(readRows(dayRows), words, prefix, now, limit - ids.length).map((p) => p.id));
+    if (ids.length >= limit) break;
+  }
+  return { ids, read };
+}
+
+// ===========================================================================
+// Runner
+// ===========================================================================
+
+function best<T>(fn: () => T): { ms: number; value: T } {
+  let ms = Infinity;
+  let value!: T;
+  for (let run = 0; run < RUNS; run++) {
+    const t0 = performance.now();
+    value = fn();
+    ms = Math.min(ms, performance.now() - t0);
+  }
+  return { ms, value };
+}
+
+function heapMb(): number {
+  (globalThis as { gc?: () => void }).gc?.();
+  return process.memoryUsage().heapUsed / 1e6;
+}
+
+const now = Date.now();
+const today = dayOf(now);
+
+let t0 = performance.now();
+const rows = generateGuide(PROGRAMME_COUNT, now);
+console.log(
+  `Guide: ${PROGRAMME_COUNT.toLocaleString()} programmes in ${rows.length.toLocaleString()} blocks, ` +
+  `generated and indexed in ${((performance.now() - t0) / 1000).toFixed(1)} s`
+);
+
+const windowRows = rows.filter((row) => row.day >= today - 1 && row.day <= today + 1);
+const heapBefore = heapMb();
+t0 = performance.now();
+const loaded = readRows(windowRows);
+const decodeMs = performance.now() - t0;
+t0 = performance.now();
+const searchWindow = new SearchWindow(today - 1, today + 1);
+for (const { entry, block } of loaded) searchWindow.put(entry, block);
+const buildMs = performance.now() - t0;
+console.log(
+  `Window load: ${windowRows.length.toLocaleString()} blocks, decode ${decodeMs.toFixed(0)} ms, ` +
+  `build ${buildMs.toFixed(0)} ms, ${(heapMb() - heapBefore).toFixed(0)} MB heap\n`
+);
+
+console.log(`EPG search: limit ${RESULT_LIMIT}, best of ${RUNS} (blocks read in parentheses)\n`);
+console.log(`${'query'.padEnd(16)} ${'baseline'.padStart(18)} ${'window'.padStart(16)}  hits`);
+
+for (const query of QUERIES) {
+  const terms = [...new Set(tokenize(query))];
+  const prefix = terms[terms.length - 1];
+  const words = terms.slice(0, -1);
+
+  // Index lookups, not timed
+  const allDays = rowsByDay(rows, words, prefix, today - 2);
+  const laterDays = rowsByDay(rows, words, prefix, today + 1);
+
+  const before = best(() => searchDays(allDays, words, prefix, now, RESULT_LIMIT));
+  const after = best(() => {
+    const ids = searchWindow.search(words, prefix, now, RESULT_LIMIT).map((p) => p.id);
+    if (ids.length >= RESULT_LIMIT) return { ids, read: 0 };
+    const later = searchDays(laterDays, words, prefix, now, RESULT_LIMIT - ids.length);
+    return { ids: [...ids, ...later.ids], read: later.read };
+  });
+
+  const same = before.value.ids.length === after.value.ids.length
+    && before.value.ids.every((id, i) => id === after.value.ids[i]);
+  console.log(
+    `${query.padEnd(16)} ${before.ms.toFixed(1).padStart(7)} ms (${String(before.value.read).padStart(5)}) ` +
+    `${after.ms.toFixed(1).padStart(6)} ms (${String(after.value.read).padStart(5)})  ` +
+    `${String(after.value.ids.length).padStart(4)}${same ? '' : '  (results differ)'}`
+  );
+}
@@ -9,8 +9,8 @@ import { MoviesPage } from './components/MoviesPage';
 import { SeriesPage } from './components/SeriesPage';
 import { Logo } from './components/Logo';
 import { useSelectedCategory } from './hooks/useChannels';
-import { useChannelSyncing, useVodSyncing, useTmdbMatching } from './stores/uiStore';
-import { syncAllSources, syncAllVod, syncVodForSource, isVodStale } from './db/sync';
+import { useChannelSyncing, useVodSyncing, useTmdbMatching, useEpgProgress, useCatalogProgress } from './stores/uiStore';
+import { startBackgroundSync } from './db/sync-client';
 import type { StoredChannel } from './db';
 import type { VodPlayInfo } from './types/media';
 
@@ -110,9 +110,12 @@ function App() {
   const channelSyncing = useChannelSyncing();
   const vodSyncing = useVodSyncing();
   const tmdbMatching = useTmdbMatching();
-
-  // Sync state
-  const [syncing, setSyncing] = useState(false);
+  const epgProgress = useEpgProgress();
+  const catalogProgress = Object.values(useCatalogProgress());
+  const catalogCategories = catalogProgress.reduce(
+    (sum, p) => ({ done: sum.done + p.done, total: sum.total + p.total }),
+    { done: 0, total: 0 }
+  );
 
   // Track volume slider dragging to ignore mpv updates during drag
   const volumeDraggingRef = useRef(false);
@@ -274,35 +277,8 @@ function App() {
     }
   };
 
-  // Sync sources on app load (if sources exist)
-  useEffect(() => {
-    const doInitialSync = async () => {
-      if (!window.storage) return;
-      const result = await window.storage.getSources();
-      if (result.data && result.data.length > 0) {
-        setSyncing(true);
-        await syncAllSources();
-
-        // Get user's configured refresh settings
-        const settingsResult = await window.storage.getSettings();
-        const vodRefreshHours = settingsResult.data?.vodRefreshHours ?? 24;
-
-        // Sync VOD only for Xtream sources that are stale
-        const xtreamSources = result.data.filter(s => s.type === 'xtream' && s.enabled);
-        for (const source of xtreamSources) {
-          const stale = await isVodStale(source.id, vodRefreshHours);
-          if (stale) {
-            console.log(`[VOD] Source ${source.name} is stale, syncing...`);
-            await syncVodForSource(source);
-          } else {
-            console.log(`[VOD] Source ${source.name} is fresh, skipping sync`);
-          }
-        }
-        setSyncing(false);
-      }
-    };
-    doInitialSync();
-  }, []);
+  // Startup sync, EPG refresh and compaction (run by the sync daemon when there is one)
+  useEffect(() => startBackgroundSync(), []);
 
   // Keyboard shortcuts
   useEffect(() => {
@@ -374,6 +350,10 @@ function App() {
                 <span className="sync-status__text">
                   {channelSyncing && vodSyncing
                     ? 'Syncing channels & VOD...'
+                    : catalogProgress.length > 0
+                    ? `Syncing ${channelSyncing ? 'channels' : 'VOD'}... (${catalogCategories.done}/${catalogCategories.total} categories)`
+                    : channelSyncing && epgProgress
+                    ? `Loading TV guide... (${epgProgress.stored.toLocaleString()} programs)`
                     : channelSyncing
                     ? 'Syncing channels...'
                     : vodSyncing
@@ -1,9 +1,10 @@
 import { useState, useEffect, useMemo, useRef, useCallback } from 'react';
-import { Virtuoso } from 'react-virtuoso';
+import { Virtuoso, type ListRange } from 'react-virtuoso';
 import { useChannels, useCategories, useProgramsInRange } from '../hooks/useChannels';
 import { useTimeGrid } from '../hooks/useTimeGrid';
 import { ChannelRow } from './ChannelRow';
 import type { StoredChannel } from '../db';
+import { requestShortEpg } from '../db/short-epg';
 import './ChannelPanel.css';
 
 // Width of the channel info column
@@ -111,6 +112,12 @@ export function ChannelPanel({
   // Fetch programs for the preload window
   const programs = useProgramsInRange(streamIds, loadStart, loadEnd);
 
+  // On-demand EPG sources: fetch short EPG for the rows Virtuoso renders
+  const handleRangeChanged = useCallback(
+    (range: ListRange) => requestShortEpg(channels.slice(range.startIndex, range.endIndex + 1)),
+    [channels]
+  );
+
   // Update current time every minute
   useEffect(() => {
     const timer = setInterval(() => setCurrentTime(new Date()), 60000);
@@ -249,6 +256,7 @@ export function ChannelPanel({
         <Virtuoso
           data={channels}
           className="guide-channels"
+          rangeChanged={handleRangeChanged}
           itemContent={(index, channel) => (
             <ChannelRow
               channel={channel}
@@ -1,6 +1,6 @@
 import { memo } from 'react';
 import { ProgramBlock, EmptyProgramBlock } from './ProgramBlock';
-import type { StoredChannel, StoredProgram } from '../db';
+import type { StoredChannel, ProgramSummary } from '../db';
 
 // Width of the channel info column (must match ChannelPanel)
 const CHANNEL_COLUMN_WIDTH = 280;
@@ -8,7 +8,7 @@ const CHANNEL_COLUMN_WIDTH = 280;
 interface ChannelRowProps {
   channel: StoredChannel;
   index: number;
-  programs: StoredProgram[];
+  programs: ProgramSummary[];
   windowStart: Date;
   windowEnd: Date;
   pixelsPerHour: number;
@@ -1,7 +1,7 @@
 import { type ChangeEvent, useEffect, useState, useRef, useCallback } from 'react';
 import type { StoredChannel } from '../db';
 import type { VodPlayInfo } from '../types/media';
-import { useCurrentProgram } from '../hooks/useChannels';
+import { useCurrentProgram, useProgramDescription } from '../hooks/useChannels';
 import './NowPlayingBar.css';
 
 interface NowPlayingBarProps {
@@ -61,6 +61,7 @@ export function NowPlayingBar({
 }: NowPlayingBarProps) {
   const canControl = mpvReady && channel !== null;
   const currentProgram = useCurrentProgram(channel?.stream_id ?? null);
+  const programDescription = useProgramDescription(isVod ? null : currentProgram?.id ?? null);
 
   // Progress tracking for live TV - updates every second
   const [progress, setProgress] = useState(0);
@@ -220,12 +221,12 @@ export function NowPlayingBar({
             </div>
 
             {/* Divider + Description (VOD plot or TV program description) */}
-            {(isVod ? vodInfo?.plot : currentProgram?.description) && (
+            {(isVod ? vodInfo?.plot : programDescription) && (
               <>
                 <div className="npb-divider" />
                 <div className="npb-description-section">
-                  <span className="npb-program-desc" title={isVod ? vodInfo?.plot : currentProgram?.description}>
-                    {isVod ? vodInfo?.plot : currentProgram?.description}
+                  <span className="npb-program-desc" title={isVod ? vodInfo?.plot : programDescription}>
+                    {isVod ? vodInfo?.plot : programDescription}
                   </span>
                 </div>
               </>
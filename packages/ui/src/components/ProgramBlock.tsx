@@ -1,9 +1,10 @@
 import { useMemo, memo } from 'react';
-import type { StoredProgram } from '../db';
+import type { ProgramSummary } from '../db';
+import { useProgramDescription } from '../hooks/useChannels';
 import './ProgramBlock.css';
 
 interface ProgramBlockProps {
-  program: StoredProgram;
+  program: ProgramSummary;
   windowStart: Date;
   windowEnd: Date;
   pixelsPerHour: number;
@@ -20,7 +21,7 @@ interface ProgramStyle {
 const PROGRAM_GAP = 2;
 
 function getProgramStyle(
-  program: StoredProgram,
+  program: ProgramSummary,
   windowStart: Date,
   windowEnd: Date,
   pixelsPerHour: number
@@ -79,13 +80,13 @@ export const ProgramBlock = memo(function ProgramBlock({
     return d.toLocaleTimeString([], { hour: '2-digit', minute: '2-digit' });
   };
 
+  // Description lives in a side table - only load it when the block is wide enough to show it
+  const description = useProgramDescription(style.visible && style.width > 200 ? program.id : null);
+
   if (!style.visible) {
     return null;
   }
 
-  // Determine if we should show description (only if block is wide enough)
-  const showDescription = style.width > 200 && program.description;
-
   return (
     <div
       className={`program-block ${isCurrent ? 'current' : ''}`}
@@ -94,11 +95,11 @@ export const ProgramBlock = memo(function ProgramBlock({
         width: `${style.width}px`,
       }}
       onClick={onClick}
-      title={`${program.title}\n${formatTime(program.start)} - ${formatTime(program.end)}${program.description ? `\n\n${program.description}` : ''}`}
+      title={`${program.title}\n${formatTime(program.start)} - ${formatTime(program.end)}${description ? `\n\n${description}` : ''}`}
     >
       <span className="program-block-title">{program.title}</span>
-      {showDescription && (
-        <span className="program-block-desc">{program.description}</span>
+      {description && (
+        <span className="program-block-desc">{description}</span>
       )}
     </div>
   );
@@ -43,6 +43,8 @@ export function Settings({ onClose }: SettingsProps) {
   // Refresh settings state
   const [vodRefreshHours, setVodRefreshHours] = useState(24);
   const [epgRefreshHours, setEpgRefreshHours] = useState(6);
+  const [epgRetentionPastHours, setEpgRetentionPastHours] = useState(24);
+  const [epgRetentionFutureDays, setEpgRetentionFutureDays] = useState(3);
 
   // Genre settings state
   const [movieGenresEnabled, setMovieGenresEnabled] = useState<number[] | undefined>(undefined);
@@ -97,6 +99,8 @@ export function Settings({ onClose }: SettingsProps) {
         tmdbApiKey?: string;
         vodRefreshHours?: number;
         epgRefreshHours?: number;
+        epgRetentionPastHours?: number;
+        epgRetentionFutureDays?: number;
         movieGenresEnabled?: number[];
         seriesGenresEnabled?: number[];
         posterDbApiKey?: string;
@@ -118,6 +122,12 @@ export function Settings({ onClose }: SettingsProps) {
       if (settings.epgRefreshHours !== undefined) {
         setEpgRefreshHours(settings.epgRefreshHours);
       }
+      if (settings.epgRetentionPastHours !== undefined) {
+        setEpgRetentionPastHours(settings.epgRetentionPastHours);
+      }
+      if (settings.epgRetentionFutureDays !== undefined) {
+        setEpgRetentionFutureDays(settings.epgRetentionFutureDays);
+      }
 
       // Load genre settings
       setMovieGenresEnabled(settings.movieGenresEnabled);
@@ -182,8 +192,12 @@ export function Settings({ onClose }: SettingsProps) {
           <DataRefreshTab
             vodRefreshHours={vodRefreshHours}
             epgRefreshHours={epgRefreshHours}
+            epgRetentionPastHours={epgRetentionPastHours}
+            epgRetentionFutureDays={epgRetentionFutureDays}
             onVodRefreshChange={setVodRefreshHours}
             onEpgRefreshChange={setEpgRefreshHours}
+            onEpgRetentionPastChange={setEpgRetentionPastHours}
+            onEpgRetentionFutureChange={setEpgRetentionFutureDays}
           />
         );
       case 'movies':
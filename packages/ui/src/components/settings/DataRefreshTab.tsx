@@ -1,21 +1,118 @@
+import { useEffect, useState } from 'react';
+import { runEpgCompaction } from '../../db/epg-compaction';
+import { useCatalogBackend, setCatalogBackend, getCatalogTimings, type CatalogBackend, type CatalogTiming } from '../../db/catalog-backend';
+import { mirrorAllCatalogs } from '../../db/catalog-mirror';
+import type { CatalogStats, FetchHostStats, HttpCacheStats } from '../../types/electron';
+
+// How often network stats are re-read while the tab is open
+const STATS_POLL_MS = 3000;
+
+function formatCacheStats(stats: HttpCacheStats): string {
+  const served = stats.hits + stats.revalidated;
+  const total = served + stats.misses;
+  const ratio = total > 0 ? Math.round((served / total) * 100) : 0;
+  const sizeMb = Math.round(stats.size / (1024 * 1024));
+  return `${stats.entries} files, ${sizeMb} MB - ${ratio}% served from disk (${stats.hits} fresh, ${stats.revalidated} unchanged, ${stats.misses} downloaded)`;
+}
+
+function formatCatalogStats(stats: CatalogStats): string {
+  const sizeMb = Math.round(stats.size / (1024 * 1024));
+  return `${stats.movies} movies, ${stats.series} series, ${stats.channels} channels, ${sizeMb} MB`;
+}
+
+// Average per query and backend, e.g. "IndexedDB 41.2 ms (12) / SQLite 3.1 ms (15)"
+function formatCatalogTimings(timings: CatalogTiming[]): { query: string; text: string }[] {
+  const queries = [...new Set(timings.map((t) => t.query))].sort();
+  return queries.map((query) => ({
+    query,
+    text: (['indexeddb', 'sqlite'] as const)
+      .map((backend) => {
+        const timing = timings.find((t) => t.query === query && t.backend === backend);
+        const name = backend === 'sqlite' ? 'SQLite' : 'IndexedDB';
+        return timing ? `${name} ${(timing.totalMs / timing.count).toFixed(1)} ms (${timing.count})` : `${name} -`;
+      })
+      .join(' / '),
+  }));
+}
+
 interface DataRefreshTabProps {
   vodRefreshHours: number;
   epgRefreshHours: number;
+  epgRetentionPastHours: number;
+  epgRetentionFutureDays: number;
   onVodRefreshChange: (hours: number) => void;
   onEpgRefreshChange: (hours: number) => void;
+  onEpgRetentionPastChange: (hours: number) => void;
+  onEpgRetentionFutureChange: (days: number) => void;
 }
 
 export function DataRefreshTab({
   vodRefreshHours,
   epgRefreshHours,
+  epgRetentionPastHours,
+  epgRetentionFutureDays,
   onVodRefreshChange,
   onEpgRefreshChange,
+  onEpgRetentionPastChange,
+  onEpgRetentionFutureChange,
 }: DataRefreshTabProps) {
+  const [hostStats, setHostStats] = useState<FetchHostStats[]>([]);
+  const [cacheStats, setCacheStats] = useState<HttpCacheStats | null>(null);
+  const catalogBackend = useCatalogBackend();
+  const [catalogStats, setCatalogStats] = useState<CatalogStats | null>(null);
+  const [catalogTimings, setCatalogTimings] = useState<CatalogTiming[]>([]);
+  const [catalogCopying, setCatalogCopying] = useState(false);
+  const [catalogError, setCatalogError] = useState<string | null>(null);
+
+  useEffect(() => {
+    const load = async () => {
+      setCatalogTimings(getCatalogTimings());
+      if (window.catalog) {
+        const catalog = await window.catalog.getStats();
+        if (catalog.data) setCatalogStats(catalog.data);
+      }
+      if (!window.fetchProxy) return;
+      const [hosts, cache] = await Promise.all([
+        window.fetchProxy.getStats(),
+        window.fetchProxy.getCacheStats(),
+      ]);
+      if (hosts.data) setHostStats(hosts.data);
+      if (cache.data) setCacheStats(cache.data);
+    };
+    load();
+    const timer = setInterval(load, STATS_POLL_MS);
+    return () => clearInterval(timer);
+  }, []);
+
   async function saveRefreshSettings(vod: number, epg: number) {
     if (!window.storage) return;
     await window.storage.updateSettings({ vodRefreshHours: vod, epgRefreshHours: epg });
   }
 
+  async function saveRetentionSettings(pastHours: number, futureDays: number) {
+    if (!window.storage) return;
+    await window.storage.updateSettings({ epgRetentionPastHours: pastHours, epgRetentionFutureDays: futureDays });
+    // Apply a tighter window right away instead of waiting for the next run
+    runEpgCompaction();
+  }
+
+  async function changeCatalogBackend(value: CatalogBackend) {
+    setCatalogError(null);
+    if (value === 'sqlite') {
+      // Bring the SQLite copy up to date before queries switch to it
+      setCatalogCopying(true);
+      try {
+        await mirrorAllCatalogs();
+      } catch (err) {
+        setCatalogError(err instanceof Error ? err.message : 'Copy failed');
+        return;
+      } finally {
+        setCatalogCopying(false);
+      }
+    }
+    await setCatalogBackend(value);
+  }
+
   return (
     <div className="settings-tab-content">
       <div className="settings-section">
@@ -66,6 +163,131 @@ export function DataRefreshTab({
           </div>
         </div>
       </div>
+
+      <div className="settings-section">
+        <div className="section-header">
+          <h3>TV Guide Storage</h3>
+        </div>
+        <p className="section-description">
+          Limit how much guide data is kept. Older and far-future programs are
+          pruned in the background to keep the guide fast.
+        </p>
+
+        <div className="refresh-settings">
+          <div className="form-group inline">
+            <label>Keep history</label>
+            <select
+              value={epgRetentionPastHours}
+              onChange={(e) => {
+                const val = parseInt(e.target.value);
+                onEpgRetentionPastChange(val);
+                saveRetentionSettings(val, epgRetentionFutureDays);
+              }}
+            >
+              <option value={6}>6 hours</option>
+              <option value={12}>12 hours</option>
+              <option value={24}>24 hours</option>
+              <option value={48}>2 days</option>
+              <option value={168}>1 week</option>
+            </select>
+          </div>
+
+          <div className="form-group inline">
+            <label>Keep upcoming</label>
+            <select
+              value={epgRetentionFutureDays}
+              onChange={(e) => {
+                const val = parseInt(e.target.value);
+                onEpgRetentionFutureChange(val);
+                saveRetentionSettings(epgRetentionPastHours, val);
+              }}
+            >
+              <option value={1}>1 day</option>
+              <option value={3}>3 days</option>
+              <option value={7}>7 days</option>
+              <option value={0}>Everything</option>
+            </select>
+          </div>
+        </div>
+      </div>
+
+      {window.catalog && (
+        <div className="settings-section">
+          <div className="section-header">
+            <h3>Catalog Storage</h3>
+          </div>
+          <p className="section-description">
+            Where movie, series and channel lists are queried from. SQLite keeps
+            a copy of the catalog with a full-text index and loads long lists a
+            page at a time; search matches the start of words instead of any
+            part of a name. Query times below are averages since the app started.
+          </p>
+
+          <div className="refresh-settings">
+            <div className="form-group inline">
+              <label>Backend</label>
+              <select
+                value={catalogBackend ?? 'indexeddb'}
+                disabled={catalogCopying || catalogBackend === null}
+                onChange={(e) => changeCatalogBackend(e.target.value as CatalogBackend)}
+              >
+                <option value="indexeddb">IndexedDB</option>
+                <option value="sqlite">SQLite</option>
+              </select>
+              {catalogCopying && <span>Copying catalog...</span>}
+              {catalogError && <span>{catalogError}</span>}
+            </div>
+            {catalogStats && (
+              <div className="form-group inline">
+                <label>SQLite copy</label>
+                <span>{formatCatalogStats(catalogStats)}</span>
+              </div>
+            )}
+            {formatCatalogTimings(catalogTimings).map(({ query, text }) => (
+              <div key={query} className="form-group inline">
+                <label>{query}</label>
+                <span>{text}</span>
+              </div>
+            ))}
+          </div>
+        </div>
+      )}
+
+      <div className="settings-section">
+        <div className="section-header">
+          <h3>Network</h3>
+        </div>
+        <p className="section-description">
+          Requests per provider since the app started. Busy or failing servers
+          are retried with backoff and limited to a few connections at a time;
+          identical requests made at the same time are shared. Downloads are
+          cached on disk and only fetched again when they have changed.
+        </p>
+
+        <div className="refresh-settings">
+          {cacheStats && (
+            <div className="form-group inline">
+              <label>Disk cache</label>
+              <span>{formatCacheStats(cacheStats)}</span>
+            </div>
+          )}
+          {hostStats.length === 0 && (
+            <p className="section-description">No requests yet.</p>
+          )}
+          {hostStats.map((stats) => (
+            <div key={stats.host} className="form-group inline">
+              <label>{stats.host}</label>
+              <span>
+                {stats.requests} requests, avg {stats.avgLatencyMs} ms
+                {stats.coalescedHits > 0 && `, ${stats.coalescedHits} shared`}
+                {stats.retries > 0 && `, ${stats.retries} retries`}
+                {stats.failures > 0 && `, ${stats.failures} failed`}
+                {stats.active + stats.queued > 0 && ` (${stats.active} active, ${stats.queued} queued)`}
+              </span>
+            </div>
+          ))}
+        </div>
+      </div>
     </div>
   );
 }
@@ -1,11 +1,14 @@
 import { useState } from 'react';
 import { createPortal } from 'react-dom';
 import type { Source } from '../../types/electron';
-import { syncAllSources, syncAllVod, markSourceDeleted, type SyncResult, type VodSyncResult } from '../../db/sync';
-import { clearSourceData, clearVodData, db } from '../../db';
+import type { SyncResult, VodSyncResult } from '../../db/sync';
+import { requestSourceSync, requestVodSync, cancelSync, notifySourceDeleted } from '../../db/sync-client';
+import { mirrorSyncChange, removeSourceCatalog } from '../../db/catalog-mirror';
+import { clearSourceData, clearVodData } from '../../db';
 import { useSyncStatus } from '../../hooks/useChannels';
-import { useChannelSyncing, useSetChannelSyncing, useVodSyncing, useSetVodSyncing } from '../../stores/uiStore';
-import { parseM3U } from '@sbtltv/local-adapter';
+import { useChannelSyncing, useVodSyncing } from '../../stores/uiStore';
+import { invalidateShortEpgSources } from '../../db/short-epg';
+import { parseM3UImport, commitM3UImport, discardM3UImport, type M3UImportProgress } from '../../db/m3u-import';
 
 interface SourcesTabProps {
   sources: Source[];
@@ -22,6 +25,8 @@ interface SourceFormData {
   username: string;
   password: string;
   autoLoadEpg: boolean;
+  epgOnDemand: boolean;
+  fetchByCategory: boolean;
   epgUrl: string;
 }
 
@@ -32,6 +37,8 @@ const emptyForm: SourceFormData = {
   username: '',
   password: '',
   autoLoadEpg: true,
+  epgOnDemand: false,
+  fetchByCategory: false,
   epgUrl: '',
 };
 
@@ -45,26 +52,32 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
   const [vodSyncResults, setVodSyncResults] = useState<Map<string, VodSyncResult> | null>(null);
   const syncStatus = useSyncStatus();
 
-  // Global sync state - persists across Settings open/close
+  // Global sync state - persists across Settings open/close (set by the sync daemon)
   const syncing = useChannelSyncing();
-  const setSyncing = useSetChannelSyncing();
   const vodSyncing = useVodSyncing();
-  const setVodSyncing = useSetVodSyncing();
 
   const hasXtreamSource = sources.some(s => s.type === 'xtream');
 
   // Track imported M3U data (file import flow)
+  // The parsed channels stay in the import worker until the source is saved
   const [importedM3U, setImportedM3U] = useState<{
+    importId: string;
+    sourceId: string;
     channels: number;
     categories: number;
     epgUrl?: string;
-    rawContent: string;
   } | null>(null);
+  const [importProgress, setImportProgress] = useState<M3UImportProgress | null>(null);
+
+  function clearImportedM3U() {
+    if (importedM3U) discardM3UImport(importedM3U.importId);
+    setImportedM3U(null);
+  }
 
   function handleAdd() {
     setFormData(emptyForm);
     setEditingId(null);
-    setImportedM3U(null);
+    clearImportedM3U();
     setShowAddForm(true);
     setError(null);
   }
@@ -73,19 +86,33 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
     if (!window.storage) return;
 
     const result = await window.storage.importM3UFile();
+    if (result.error) {
+      setError(result.error);
+      return;
+    }
     if (result.canceled || !result.data) return;
 
-    const { content, fileName } = result.data;
+    const { importId, fileName } = result.data;
 
-    // Parse to validate and extract info
-    const tempSourceId = 'temp-import';
-    const parsed = parseM3U(content, tempSourceId);
+    // Parse with the id the source will be saved under, so saving is just a write
+    const sourceId = crypto.randomUUID();
+    setImportProgress({ bytes: 0, channels: 0 });
+    let parsed;
+    try {
+      parsed = await parseM3UImport(importId, sourceId, setImportProgress);
+    } catch (err) {
+      setError(err instanceof Error ? err.message : 'Failed to import playlist');
+      return;
+    } finally {
+      setImportProgress(null);
+    }
 
     setImportedM3U({
-      channels: parsed.channels.length,
-      categories: parsed.categories.length,
+      importId,
+      sourceId,
+      channels: parsed.channelCount,
+      categories: parsed.categoryCount,
       epgUrl: parsed.epgUrl ?? undefined,
-      rawContent: content,
     });
 
     setFormData({
@@ -110,6 +137,8 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
       username: source.username || '',
       password: source.password || '',
       autoLoadEpg: source.auto_load_epg ?? (source.type === 'xtream'),
+      epgOnDemand: source.epg_mode === 'on_demand',
+      fetchByCategory: !!source.fetch_by_category,
       epgUrl: source.epg_url || '',
     });
     setEditingId(source.id);
@@ -126,11 +155,12 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
     if (!confirmed) return;
 
     // Mark source as deleted FIRST - prevents sync from writing results after deletion
-    markSourceDeleted(id);
+    notifySourceDeleted(id);
 
     // Clean up all data in IndexedDB before removing source config
     await clearSourceData(id);
     await clearVodData(id);
+    await removeSourceCatalog(id);
     await window.storage.deleteSource(id);
     onSourcesChange();
   }
@@ -154,7 +184,7 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
       return;
     }
 
-    const sourceId = editingId || crypto.randomUUID();
+    const sourceId = editingId || importedM3U?.sourceId || crypto.randomUUID();
 
     const source: Source = {
       id: sourceId,
@@ -165,6 +195,8 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
       username: formData.type === 'xtream' ? formData.username.trim() : undefined,
       password: formData.type === 'xtream' ? formData.password.trim() : undefined,
       auto_load_epg: formData.autoLoadEpg,
+      epg_mode: formData.type === 'xtream' && formData.epgOnDemand ? 'on_demand' : undefined,
+      fetch_by_category: formData.type === 'xtream' && formData.fetchByCategory ? true : undefined,
       epg_url: formData.epgUrl.trim() || undefined,
     };
 
@@ -173,26 +205,17 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
       setError(result.error);
       return;
     }
+    invalidateShortEpgSources();
 
-    // For file imports, store channels directly in the database
+    // For file imports, store the already parsed channels
     if (importedM3U) {
-      const parsed = parseM3U(importedM3U.rawContent, sourceId);
-
-      await db.transaction('rw', [db.channels, db.categories, db.sourcesMeta], async () => {
-        if (parsed.channels.length > 0) {
-          await db.channels.bulkPut(parsed.channels);
-        }
-        if (parsed.categories.length > 0) {
-          await db.categories.bulkPut(parsed.categories);
-        }
-        await db.sourcesMeta.put({
-          source_id: sourceId,
-          epg_url: parsed.epgUrl ?? undefined,
-          last_synced: new Date(),
-          channel_count: parsed.channels.length,
-          category_count: parsed.categories.length,
-        });
-      });
+      try {
+        await commitM3UImport(importedM3U.importId);
+        mirrorSyncChange({ sourceId, scope: 'channels' });
+      } catch (err) {
+        setError(err instanceof Error ? err.message : 'Failed to store playlist');
+        return;
+      }
     }
 
     setShowAddForm(false);
@@ -206,37 +229,32 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
     setShowAddForm(false);
     setFormData(emptyForm);
     setEditingId(null);
-    setImportedM3U(null);
+    clearImportedM3U();
     setError(null);
   }
 
-  async function handleSync() {
-    setSyncing(true);
+  // sourceId: refresh a single source now, otherwise all enabled sources
+  async function handleSync(sourceId?: string) {
     setSyncResults(null);
     setSyncError(null);
     try {
-      const results = await syncAllSources();
+      const results = await requestSourceSync(sourceId);
       setSyncResults(results);
     } catch (err) {
       console.error('Sync error:', err);
       setSyncError(err instanceof Error ? err.message : 'Channel sync failed');
-    } finally {
-      setSyncing(false);
     }
   }
 
   async function handleVodSync() {
-    setVodSyncing(true);
     setVodSyncResults(null);
     setSyncError(null);
     try {
-      const results = await syncAllVod();
+      const results = await requestVodSync();
       setVodSyncResults(results);
     } catch (err) {
       console.error('VOD sync error:', err);
       setSyncError(err instanceof Error ? err.message : 'VOD sync failed');
-    } finally {
-      setVodSyncing(false);
     }
   }
 
@@ -249,7 +267,7 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
           <div className="section-actions">
             <button
               className="sync-btn"
-              onClick={handleSync}
+              onClick={() => handleSync()}
               disabled={syncing || sources.length === 0}
             >
               {syncing ? 'Syncing...' : 'Sync Channels'}
@@ -261,6 +279,9 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
             >
               {vodSyncing ? 'Syncing...' : 'Sync Movies & Series'}
             </button>
+            {(syncing || vodSyncing) && (
+              <button className="sync-btn" onClick={cancelSync}>Cancel Sync</button>
+            )}
             <button className="add-btn" onClick={handleAdd}>+ Add Source</button>
           </div>
         </div>
@@ -283,6 +304,7 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
                   <span className="source-type">{source.type.toUpperCase()}</span>
                 </div>
                 <div className="source-actions">
+                  <button onClick={() => handleSync(source.id)} disabled={syncing || !source.enabled}>Sync</button>
                   <button onClick={() => handleEdit(source)}>Edit</button>
                   <button className="delete" onClick={() => handleDelete(source.id, source.name)}>Delete</button>
                 </div>
@@ -408,8 +430,11 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
                   type="button"
                   className="import-btn"
                   onClick={handleImportM3U}
+                  disabled={!!importProgress}
                 >
-                  Import from File...
+                  {importProgress
+                    ? `Importing... (${importProgress.channels.toLocaleString()} channels)`
+                    : 'Import from File...'}
                 </button>
               </div>
             )}
@@ -426,7 +451,7 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
                 <button
                   type="button"
                   className="change-file-btn"
-                  onClick={() => setImportedM3U(null)}
+                  onClick={clearImportedM3U}
                 >
                   Use URL instead
                 </button>
@@ -478,6 +503,38 @@ export function SourcesTab({ sources, isEncryptionAvailable, onSourcesChange }:
               </span>
             </div>
 
+            {formData.type === 'xtream' && (
+              <div className="form-group">
+                <label className="checkbox-label">
+                  <input
+                    type="checkbox"
+                    checked={formData.fetchByCategory}
+                    onChange={(e) => setFormData({ ...formData, fetchByCategory: e.target.checked })}
+                  />
+                  Fetch catalog by category
+                </label>
+                <span className="hint">
+                  Loads channels, movies and series one category at a time so the first categories can be browsed while the rest downloads (for very large sources)
+                </span>
+              </div>
+            )}
+
+            {formData.type === 'xtream' && formData.autoLoadEpg && (
+              <div className="form-group epg-settings">
+                <label className="checkbox-label">
+                  <input
+                    type="checkbox"
+                    checked={formData.epgOnDemand}
+                    onChange={(e) => setFormData({ ...formData, epgOnDemand: e.target.checked })}
+                  />
+                  Load guide on demand
+                </label>
+                <span className="hint">
+                  Skips the full XMLTV download and fetches listings only for channels you scroll to (for very large sources)
+                </span>
+              </div>
+            )}
+
             {!formData.autoLoadEpg && (
               <div className="form-group">
                 <label>EPG URL (optional)</label>
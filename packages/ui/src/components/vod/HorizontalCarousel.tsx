@@ -1,8 +1,12 @@
 import { useRef, useState, useCallback, useEffect } from 'react';
 import type { StoredMovie, StoredSeries } from '../../db';
 import { MediaCard } from './MediaCard';
+import { prefetchSeriesEpisodes } from '../../db/episode-prefetch';
 import './HorizontalCarousel.css';
 
+// Leading series cards whose episodes are prefetched (roughly one screen width)
+const PREFETCH_VISIBLE_COUNT = 6;
+
 export interface HorizontalCarouselProps {
   title: string;
   items: (StoredMovie | StoredSeries)[];
@@ -47,6 +51,13 @@ export function HorizontalCarousel({
     return () => window.removeEventListener('resize', updateScrollButtons);
   }, [updateScrollButtons, items.length]);
 
+  // Prefetch episodes for the series on screen (Virtuoso only mounts visible rows)
+  useEffect(() => {
+    if (type !== 'series' || hidden || loading) return;
+    const ids = items.slice(0, PREFETCH_VISIBLE_COUNT).map((item) => (item as StoredSeries).series_id);
+    prefetchSeriesEpisodes(ids, 'visible');
+  }, [type, hidden, loading, items]);
+
   // Scroll by amount
   const scroll = useCallback((direction: 'left' | 'right') => {
     const container = scrollContainerRef.current;
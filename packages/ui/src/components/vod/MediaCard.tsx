@@ -3,6 +3,7 @@ import { getTmdbImageUrl, TMDB_POSTER_SIZES } from '../../services/tmdb';
 import { useRpdbSettings } from '../../hooks/useRpdbSettings';
 import { getRpdbPosterUrl } from '../../services/rpdb';
 import type { StoredMovie, StoredSeries } from '../../db';
+import { prefetchSeriesEpisodes } from '../../db/episode-prefetch';
 import './MediaCard.css';
 
 export interface MediaCardProps {
@@ -70,11 +71,20 @@ export const MediaCard = memo(function MediaCard({ item, type, onClick, size = '
     [item, onClick]
   );
 
+  // Hovered or focused series are likely to be opened next - warm their episodes
+  const handleIntent = useCallback(() => {
+    if (type === 'series') {
+      prefetchSeriesEpisodes([(item as StoredSeries).series_id], 'hover');
+    }
+  }, [item, type]);
+
   return (
     <div
       className={`media-card media-card--${size}`}
       onClick={handleClick}
       onKeyDown={handleKeyDown}
+      onMouseEnter={handleIntent}
+      onFocus={handleIntent}
       tabIndex={0}
       role="button"
       aria-label={`${item.name}${year ? ` (${year})` : ''}`}
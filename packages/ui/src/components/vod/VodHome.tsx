@@ -4,7 +4,7 @@
  * Shows TMDB-curated content rows matched against local Xtream content.
  */
 
-import { useCallback } from 'react';
+import { useCallback, useEffect } from 'react';
 import { HeroSection } from './HeroSection';
 import { HorizontalCarousel } from './HorizontalCarousel';
 import type { StoredMovie, StoredSeries } from '../../db';
@@ -23,6 +23,7 @@ import {
   useTvGenres,
 } from '../../hooks/useTmdbLists';
 import { useRecentMovies, useRecentSeries } from '../../hooks/useVod';
+import { prefetchRecentSeries } from '../../db/episode-prefetch';
 import './VodHome.css';
 
 // TMDB genre IDs
@@ -59,6 +60,11 @@ export function VodHome({ type, onItemClick, onPlay }: VodHomeProps) {
   const { series: comedySeries, loading: comedySeriesLoading } = useSeriesByGenre(tmdbApiKey, GENRE_COMEDY_TV);
   const { series: recentSeries, loading: recentSeriesLoading } = useRecentSeries(20);
 
+  // Refresh stale episodes of recently opened series in the background
+  useEffect(() => {
+    if (type === 'series') prefetchRecentSeries();
+  }, [type]);
+
   const handleHeroPlay = useCallback((item: StoredMovie | StoredSeries) => {
     onPlay(item);
   }, [onPlay]);
@@ -0,0 +1,165 @@
+/**
+ * Catalog query backend
+ *
+ * Movie, series and channel browsing queries run either against IndexedDB
+ * (Dexie, the default) or against the SQLite catalog in the main process
+ * (window.catalog, kept up to date by catalog-mirror.ts). The choice is the
+ * catalogBackend setting and can be switched at runtime. Query timings are
+ * recorded per backend so the two can be compared in Settings.
+ */
+
+import { useEffect, useState, useSyncExternalStore } from 'react';
+import { useLiveQuery } from 'dexie-react-hooks';
+import type { CatalogPage, CatalogQuery } from '../types/electron';
+
+export type CatalogBackend = 'indexeddb' | 'sqlite';
+
+export interface CatalogTiming {
+  query: string;
+  backend: CatalogBackend;
+  count: number;
+  totalMs: number;
+  maxMs: number;
+}
+
+// null until the setting has been read
+let backend: CatalogBackend | null = null;
+// Bumped whenever the SQLite catalog is written
+let version = 0;
+let started = false;
+const listeners = new Set<() => void>();
+const timings = new Map<string, CatalogTiming>();
+
+function notify(): void {
+  for (const listener of listeners) listener();
+}
+
+function start(): void {
+  if (started) return;
+  started = true;
+
+  window.catalog?.onChanged(() => {
+    version++;
+    notify();
+  });
+
+  if (!window.storage || !window.catalog) {
+    backend = 'indexeddb';
+    return;
+  }
+  window.storage.getSettings()
+    .then((result) => {
+      backend = result.data?.catalogBackend === 'sqlite' ? 'sqlite' : 'indexeddb';
+    })
+    .catch(() => {
+      backend = 'indexeddb';
+    })
+    .finally(notify);
+}
+
+function subscribe(listener: () => void): () => void {
+  start();
+  listeners.add(listener);
+  return () => listeners.delete(listener);
+}
+
+/**
+ * Selected backend (null while the setting loads)
+ */
+export function useCatalogBackend(): CatalogBackend | null {
+  return useSyncExternalStore(subscribe, () => backend);
+}
+
+/**
+ * Changes whenever the SQLite catalog is written - a dependency for SQLite
+ * queries that should refresh like Dexie live queries do
+ */
+export function useCatalogVersion(): number {
+  return useSyncExternalStore(subscribe, () => version);
+}
+
+/**
+ * Switch backends (the SQLite catalog should be mirrored first)
+ */
+export async function setCatalogBackend(value: CatalogBackend): Promise<void> {
+  await window.storage?.updateSettings({ catalogBackend: value });
+  backend = value;
+  notify();
+}
+
+/**
+ * Run a catalog query and record its duration under `query`
+ */
+export async function timedCatalogQuery<T>(query: string, queryBackend: CatalogBackend, run: () => Promise<T>): Promise<T> {
+  const startedAt = performance.now();
+  const result = await run();
+  const ms = performance.now() - startedAt;
+
+  const key = `${query}|${queryBackend}`;
+  const timing = timings.get(key) ?? { query, backend: queryBackend, count: 0, totalMs: 0, maxMs: 0 };
+  timing.count++;
+  timing.totalMs += ms;
+  timing.maxMs = Math.max(timing.maxMs, ms);
+  timings.set(key, timing);
+  return result;
+}
+
+/**
+ * Query timings since startup
+ */
+export function getCatalogTimings(): CatalogTiming[] {
+  return [...timings.values()];
+}
+
+/**
+ * One page from the SQLite catalog
+ */
+export async function querySqliteCatalog<T>(query: CatalogQuery): Promise<CatalogPage<T>> {
+  if (!window.catalog) throw new Error('SQLite catalog unavailable');
+  const result = await window.catalog.query(query);
+  if (!result.success || !result.data) {
+    throw new Error(result.error ?? 'Catalog query failed');
+  }
+  return result.data as CatalogPage<T>;
+}
+
+/**
+ * Run a query on the selected catalog backend. IndexedDB queries are Dexie
+ * live queries; SQLite queries re-run whenever the catalog is written.
+ * Returns undefined while loading.
+ */
+export function useCatalogQuery<T>(
+  label: string,
+  indexedDbQuery: () => Promise<T>,
+  sqliteQuery: () => Promise<T>,
+  deps: unknown[]
+): T | undefined {
+  const backend = useCatalogBackend();
+  const version = useCatalogVersion();
+  // Tagged with the deps it was queried for: a result for other deps is not
+  // shown, while a re-run after a catalog write keeps the previous one
+  const [sqliteResult, setSqliteResult] = useState<{ deps: unknown[]; value: T } | undefined>(undefined);
+
+  const live = useLiveQuery(
+    () => (backend === 'indexeddb' ? timedCatalogQuery(label, 'indexeddb', indexedDbQuery) : undefined),
+    [backend, ...deps]
+  );
+
+  useEffect(() => {
+    if (backend !== 'sqlite') return;
+    let cancelled = false;
+    timedCatalogQuery(label, 'sqlite', sqliteQuery)
+      .then((value) => {
+        if (!cancelled) setSqliteResult({ deps, value });
+      })
+      .catch((err) => console.error('[Catalog] Query failed:', err));
+    return () => {
+      cancelled = true;
+    };
+  }, [backend, version, ...deps]);
+
+  if (backend !== 'sqlite') return live;
+  const current = !!sqliteResult && sqliteResult.deps.length === deps.length &&
+    sqliteResult.deps.every((dep, i) => Object.is(dep, deps[i]));
+  return current ? sqliteResult.value : undefined;
+}
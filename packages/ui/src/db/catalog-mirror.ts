@@ -0,0 +1,101 @@
+/**
+ * SQLite catalog mirror
+ *
+ * While the SQLite backend is selected (see catalog-backend.ts), a source's
+ * movies, series and channels are copied from IndexedDB to the main
+ * process's catalog after a sync changes them. Rows go over in batches
+ * tagged with a sync id, then the main process drops the source's rows that
+ * weren't part of the copy.
+ */
+
+import type { Table } from 'dexie';
+import { db } from './index';
+import type { SyncChange } from './sync';
+import type { CatalogKind } from '../types/electron';
+
+// Rows per IPC call (one SQLite transaction on the main process each)
+const MIRROR_BATCH_SIZE = 1000;
+
+function tableFor(kind: CatalogKind): Table<object, string> {
+  switch (kind) {
+    case 'movie': return db.vodMovies as Table<object, string>;
+    case 'series': return db.vodSeries as Table<object, string>;
+    case 'channel': return db.channels as Table<object, string>;
+  }
+}
+
+async function mirrorKind(kind: CatalogKind, sourceId: string): Promise<void> {
+  const catalog = window.catalog!;
+  const syncId = Date.now();
+  const table = tableFor(kind);
+
+  // Snapshot the keys up front: rows written by another sync during the copy
+  // can't shift a page boundary and be skipped (then dropped by finish()).
+  // Rows are then read in key batches so the catalog is never held in memory
+  // at once.
+  const keys = await table.where('source_id').equals(sourceId).primaryKeys();
+  for (let i = 0; i < keys.length; i += MIRROR_BATCH_SIZE) {
+    const rows = await table.bulkGet(keys.slice(i, i + MIRROR_BATCH_SIZE));
+    // Rows deleted since the snapshot are left out (and dropped by finish())
+    const batch = rows.filter((row): row is object => row !== undefined);
+    if (batch.length === 0) continue;
+    const result = await catalog.write(kind, sourceId, syncId, batch);
+    if (!result.success) throw new Error(result.error ?? 'Catalog write failed');
+  }
+
+  const result = await catalog.finish(kind, sourceId, syncId);
+  if (!result.success) throw new Error(result.error ?? 'Catalog write failed');
+}
+
+// Mirrors run one at a time so two copies of a source never interleave
+let queue: Promise<void> = Promise.resolve();
+
+/**
+ * Copy a source's rows of the given kinds to the SQLite catalog
+ */
+export function mirrorSourceCatalog(sourceId: string, kinds: CatalogKind[]): Promise<void> {
+  const run = queue.then(async () => {
+    for (const kind of kinds) {
+      await mirrorKind(kind, sourceId);
+    }
+  });
+  queue = run.catch(() => {});
+  return run;
+}
+
+async function isSqliteCatalogEnabled(): Promise<boolean> {
+  if (!window.catalog || !window.storage) return false;
+  const result = await window.storage.getSettings();
+  return result.data?.catalogBackend === 'sqlite';
+}
+
+/**
+ * Mirror the rows a sync changed (no-op unless the SQLite backend is selected).
+ * Partial changes are skipped, so a sync is copied once, after its last write.
+ */
+export async function mirrorSyncChange(change: SyncChange): Promise<void> {
+  if (change.scope === 'epg' || change.partial) return;
+  try {
+    if (!(await isSqliteCatalogEnabled())) return;
+    await mirrorSourceCatalog(change.sourceId, change.scope === 'vod' ? ['movie', 'series'] : ['channel']);
+  } catch (err) {
+    console.error('[Catalog] Mirror failed:', err);
+  }
+}
+
+/**
+ * Copy every synced source (before switching to the SQLite backend)
+ */
+export async function mirrorAllCatalogs(): Promise<void> {
+  const sourceIds = await db.sourcesMeta.toCollection().primaryKeys();
+  for (const sourceId of sourceIds) {
+    await mirrorSourceCatalog(sourceId, ['channel', 'movie', 'series']);
+  }
+}
+
+/**
+ * Drop a deleted source from the SQLite catalog
+ */
+export async function removeSourceCatalog(sourceId: string): Promise<void> {
+  await window.catalog?.deleteSource(sourceId);
+}
@@ -0,0 +1,217 @@
+/**
+ * Per-category Xtream catalog sync
+ *
+ * Opt-in (Source.fetch_by_category) alternative to fetching get_live_streams,
+ * get_vod_streams and get_series as one huge array. Categories are listed
+ * first, then fetched a few at a time; each category is written to Dexie as
+ * soon as it arrives, so the first ones can be browsed while the rest of the
+ * catalog is still downloading.
+ *
+ * Items that vanished from the provider are only removed when every category
+ * was fetched - a failed category must not look like an emptied one.
+ */
+
+import type { Table } from 'dexie';
+import { mapWithConcurrency, type XtreamClient } from '@sbtltv/local-adapter';
+import type { Category, Movie, Series, Source } from '@sbtltv/core';
+import { db, type StoredMovie, type StoredSeries, type VodCategory } from './index';
+import type { ChannelSyncSession } from './channel-store';
+import { useUIStore } from '../stores/uiStore';
+
+// Category requests in flight per catalog
+const CATEGORY_FETCH_CONCURRENCY = 4;
+
+export type CatalogKind = 'live' | 'movie' | 'series';
+
+export interface CatalogProgress {
+  sourceId: string;
+  kind: CatalogKind;
+  done: number;    // Categories fetched (or failed)
+  total: number;
+  items: number;   // Channels / movies / series stored so far
+}
+
+export interface CatalogFetchResult {
+  complete: boolean;  // Every category was fetched
+  failed: number;
+}
+
+/**
+ * Fetch every category with bounded concurrency, reporting progress to the
+ * UI store. `fetchCategory` stores the category and returns its item count.
+ */
+async function fetchCategories(
+  source: Source,
+  kind: CatalogKind,
+  categories: Category[],
+  fetchCategory: (category: Category) => Promise<number>
+): Promise<CatalogFetchResult> {
+  const { setCatalogProgress } = useUIStore.getState();
+  const key = `${source.id}:${kind}`;
+  const progress: CatalogProgress = { sourceId: source.id, kind, done: 0, total: categories.length, items: 0 };
+  setCatalogProgress(key, { ...progress });
+
+  try {
+    const results = await mapWithConcurrency(categories, CATEGORY_FETCH_CONCURRENCY, async (category) => {
+      try {
+        progress.items += await fetchCategory(category);
+      } catch (err) {
+        console.warn(`[Sync] Category "${category.category_name}" failed:`, err);
+        throw err;
+      } finally {
+        progress.done++;
+        setCatalogProgress(key, { ...progress });
+      }
+    });
+    const failed = results.filter((result) => result.status === 'rejected').length;
+    return { complete: failed === 0, failed };
+  } finally {
+    setCatalogProgress(key, null);
+  }
+}
+
+/**
+ * Live channels, one get_live_streams request per category.
+ * Channels go through the source's ChannelSyncSession (diffed upserts).
+ */
+export async function fetchLiveByCategory(
+  source: Source,
+  client: XtreamClient,
+  channelSync: ChannelSyncSession
+): Promise<CatalogFetchResult> {
+  const categories = await client.getLiveCategories();
+  // Categories first, so the sidebar fills in before their channels arrive
+  await channelSync.apply([], categories);
+
+  return fetchCategories(source, 'live', categories, async (category) => {
+    const channels = await client.getLiveStreams(category.category_id);
+    await channelSync.apply(channels, []);
+    return channels.length;
+  });
+}
+
+// ===========================================================================
+// VOD
+// ===========================================================================
+
+type VodItem = StoredMovie | StoredSeries;
+
+interface VodCatalog<T extends VodItem> {
+  label: string;
+  type: VodCategory['type'];
+  table: Table<T, string>;
+  keyOf: (item: Movie | Series) => string;
+  listCategories: () => Promise<Category[]>;
+  fetchCategory: (categoryId: string) => Promise<(Movie | Series)[]>;
+  removeItems: (ids: string[]) => Promise<void>;
+}
+
+async function syncVodCatalogByCategory<T extends VodItem>(
+  source: Source,
+  kind: CatalogKind,
+  catalog: VodCatalog<T>
+): Promise<{ count: number; categoryCount: number; skipped?: boolean }> {
+  let categories: Category[];
+  try {
+    categories = await catalog.listCategories();
+  } catch (err) {
+    console.warn(`[${catalog.label}] Category list failed, keeping existing data:`, err);
+    return { count: 0, categoryCount: 0, skipped: true };
+  }
+
+  // Replace categories first so they are browsable while items load
+  const vodCategories: VodCategory[] = categories.map((cat) => ({
+    category_id: cat.category_id,
+    source_id: source.id,
+    name: cat.category_name,
+    type: catalog.type,
+  }));
+  await db.transaction('rw', [db.vodCategories], async () => {
+    await db.vodCategories.where('source_id').equals(source.id).filter((c) => c.type === catalog.type).delete();
+    if (vodCategories.length > 0) {
+      await db.vodCategories.bulkPut(vodCategories);
+    }
+  });
+
+  const seen = new Set<string>();
+  const result = await fetchCategories(source, kind, categories, async (category) => {
+    const items = await catalog.fetchCategory(category.category_id);
+    if (items.length === 0) return 0;
+
+    // Preserve TMDB enrichments; an item listed in several categories keeps all of them.
+    // Categories are stored concurrently - read, merge and write in one transaction
+    // so two categories listing the same item can't overwrite each other's ids.
+    await db.transaction('rw', catalog.table, async () => {
+      const existing = await catalog.table.bulkGet(items.map(catalog.keyOf));
+      const stored = items.map((item, i) => {
+        const prev = existing[i];
+        const categoryIds = prev && seen.has(catalog.keyOf(item))
+          ? [...new Set([...prev.category_ids, ...item.category_ids])]
+          : item.category_ids;
+        return {
+          ...item,
+          category_ids: categoryIds,
+          tmdb_id: prev?.tmdb_id,
+          imdb_id: prev?.imdb_id,
+          backdrop_path: prev?.backdrop_path,
+          popularity: prev?.popularity,
+          added: prev?.added ?? new Date(),
+        } as T;
+      });
+      await catalog.table.bulkPut(stored);
+      for (const item of items) seen.add(catalog.keyOf(item));
+    });
+    return items.length;
+  });
+
+  if (result.complete) {
+    const existingIds = (await catalog.table.where('source_id').equals(source.id).primaryKeys()) as string[];
+    const toRemove = existingIds.filter((id) => !seen.has(id));
+    if (toRemove.length > 0) {
+      await catalog.removeItems(toRemove);
+      console.log(`[${catalog.label}] Removed ${toRemove.length} items no longer in source`);
+    }
+  } else {
+    console.warn(`[${catalog.label}] ${result.failed} categories failed, keeping items not seen this sync`);
+  }
+
+  const count = result.complete ? seen.size : await catalog.table.where('source_id').equals(source.id).count();
+  return { count, categoryCount: vodCategories.length };
+}
+
+/**
+ * VOD movies, one get_vod_streams request per category
+ */
+export function syncVodMoviesByCategory(source: Source, client: XtreamClient) {
+  return syncVodCatalogByCategory<StoredMovie>(source, 'movie', {
+    label: 'VOD Movies',
+    type: 'movie',
+    table: db.vodMovies,
+    keyOf: (item) => (item as Movie).stream_id,
+    listCategories: () => client.getVodCategories(),
+    fetchCategory: (categoryId) => client.getVodStreams(categoryId),
+    removeItems: (ids) => db.vodMovies.bulkDelete(ids),
+  });
+}
+
+/**
+ * VOD series, one get_series request per category
+ */
+export function syncVodSeriesByCategory(source: Source, client: XtreamClient) {
+  return syncVodCatalogByCategory<StoredSeries>(source, 'series', {
+    label: 'VOD Series',
+    type: 'series',
+    table: db.vodSeries,
+    keyOf: (item) => (item as Series).series_id,
+    listCategories: () => client.getSeriesCategories(),
+    fetchCategory: (categoryId) => client.getSeries(categoryId),
+    removeItems: async (ids) => {
+      // Episodes reference series_id - delete them with their series
+      await db.transaction('rw', [db.vodSeries, db.vodEpisodes, db.seriesEpisodeFetches], async () => {
+        await db.vodEpisodes.where('series_id').anyOf(ids).delete();
+        await db.seriesEpisodeFetches.bulkDelete(ids);
+        await db.vodSeries.bulkDelete(ids);
+      });
+    },
+  });
+}
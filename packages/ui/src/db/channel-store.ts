@@ -0,0 +1,144 @@
+/**
+ * Live channel diff sync
+ *
+ * Channel ids are stable across syncs (Xtream stream ids, content hashes for
+ * M3U), so a refresh compares incoming channels against the stored rows
+ * instead of clearing and rewriting the source: only new or changed channels
+ * and categories are written, and only channels that vanished from the list
+ * are deleted - together with their EPG rows. Guide data of unchanged
+ * channels is left alone.
+ */
+
+import type { Category, Channel } from '@sbtltv/core';
+import { db } from './index';
+import { deleteProgramBlocks } from './epg-store';
+
+// Ids per IndexedDB request when removing vanished channels
+const DELETE_CHUNK_SIZE = 1000;
+
+export interface ChannelSyncCounts {
+  written: number;    // New or changed channels
+  unchanged: number;
+  deleted: number;    // Channels no longer in the source's list
+}
+
+function sameStrings(a: string[] | undefined, b: string[] | undefined): boolean {
+  if (a === b) return true;
+  if (!a || !b || a.length !== b.length) return false;
+  return a.every((value, i) => value === b[i]);
+}
+
+function sameAttributes(a: Record<string, string> | undefined, b: Record<string, string> | undefined): boolean {
+  if (a === b) return true;
+  if (!a || !b) return false;
+  const keys = Object.keys(a);
+  return keys.length === Object.keys(b).length && keys.every((key) => a[key] === b[key]);
+}
+
+function sameChannel(a: Channel, b: Channel): boolean {
+  return a.name === b.name
+    && a.stream_icon === b.stream_icon
+    && a.epg_channel_id === b.epg_channel_id
+    && a.direct_url === b.direct_url
+    && !!a.tv_archive === !!b.tv_archive
+    && !!a.is_adult === !!b.is_adult
+    && sameStrings(a.category_ids, b.category_ids)
+    && sameAttributes(a.m3u_attributes, b.m3u_attributes);
+}
+
+/**
+ * One source's channel sync. Feed the complete list with apply() (in as many
+ * batches as convenient), then call finish() to remove what wasn't seen.
+ */
+export class ChannelSyncSession {
+  private sourceId: string;
+  private seenChannels = new Set<string>();
+  private seenCategories = new Set<string>();
+  private counts: ChannelSyncCounts = { written: 0, unchanged: 0, deleted: 0 };
+
+  constructor(sourceId: string) {
+    this.sourceId = sourceId;
+  }
+
+  get channelCount(): number {
+    return this.seenChannels.size;
+  }
+
+  get categoryCount(): number {
+    return this.seenCategories.size;
+  }
+
+  async apply(channels: Channel[], categories: Category[]): Promise<void> {
+    if (channels.length === 0 && categories.length === 0) return;
+
+    await db.transaction('rw', [db.channels, db.categories], async () => {
+      const [storedChannels, storedCategories] = await Promise.all([
+        db.channels.bulkGet(channels.map((ch) => ch.stream_id)),
+        db.categories.bulkGet(categories.map((cat) => cat.category_id)),
+      ]);
+
+      // A channel already applied this sync (per-category fetch lists it under
+      // each of its categories) keeps the categories it was stored with
+      const incoming = channels.map((ch, i) => {
+        const stored = storedChannels[i];
+        if (!stored || !this.seenChannels.has(ch.stream_id)) return ch;
+        return { ...ch, category_ids: [...new Set([...stored.category_ids, ...ch.category_ids])] };
+      });
+      const changedChannels = incoming.filter((ch, i) => {
+        const stored = storedChannels[i];
+        return !stored || !sameChannel(stored, ch);
+      });
+      const changedCategories = categories.filter((cat, i) => {
+        const stored = storedCategories[i];
+        return !stored || stored.category_name !== cat.category_name;
+      });
+
+      if (changedChannels.length > 0) {
+        await db.channels.bulkPut(changedChannels);
+      }
+      if (changedCategories.length > 0) {
+        await db.categories.bulkPut(changedCategories);
+      }
+
+      this.counts.written += changedChannels.length;
+      this.counts.unchanged += channels.length - changedChannels.length;
+      // Inside the transaction: concurrent apply() calls are serialised by
+      // IndexedDB, so the next one sees these channels as already applied
+      for (const ch of channels) this.seenChannels.add(ch.stream_id);
+    });
+
+    for (const cat of categories) this.seenCategories.add(cat.category_id);
+  }
+
+  /**
+   * Delete channels and categories of the source that were not applied,
+   * along with the guide data of those channels.
+   * Pass removeVanished: false when the list is known to be incomplete.
+   */
+  async finish(options: { removeVanished?: boolean } = {}): Promise<ChannelSyncCounts> {
+    if (options.removeVanished === false) return this.counts;
+
+    const [channelIds, categoryIds] = await Promise.all([
+      db.channels.where('source_id').equals(this.sourceId).primaryKeys(),
+      db.categories.where('source_id').equals(this.sourceId).primaryKeys(),
+    ]);
+    const vanishedChannels = channelIds.filter((id) => !this.seenChannels.has(id));
+    const vanishedCategories = categoryIds.filter((id) => !this.seenCategories.has(id));
+
+    for (let i = 0; i < vanishedChannels.length; i += DELETE_CHUNK_SIZE) {
+      const chunk = vanishedChannels.slice(i, i + DELETE_CHUNK_SIZE);
+      await db.channels.bulkDelete(chunk);
+      await db.shortEpgFetches.bulkDelete(chunk);
+      const blockKeys = await db.programBlocks.where('stream_id').anyOf(chunk).primaryKeys();
+      if (blockKeys.length > 0) {
+        await deleteProgramBlocks(blockKeys);
+      }
+    }
+    if (vanishedCategories.length > 0) {
+      await db.categories.bulkDelete(vanishedCategories);
+    }
+
+    this.counts.deleted = vanishedChannels.length;
+    return this.counts;
+  }
+}
@@ -0,0 +1,75 @@
+/**
+ * Programme description cache
+ *
+ * Descriptions are only needed for wide guide blocks and the now playing bar,
+ * so they are read from the programDescriptions side table on demand and kept
+ * in a small LRU (Map insertion order = recency) to avoid re-reading them
+ * while the guide is scrolled back and forth. Descriptions are stored per
+ * channel-day block; loading one caches its neighbours in the block too, as
+ * the guide usually asks for them next.
+ */
+
+import { db } from './index';
+import { DAY_MS, blockKeyForProgramId } from './program-blocks';
+
+const MAX_ENTRIES = 500;
+
+const cache = new Map<string, string | null>();
+const pending = new Map<string, Promise<void>>();
+
+function remember(id: string, description: string | null): void {
+  cache.delete(id);
+  cache.set(id, description);
+  if (cache.size > MAX_ENTRIES) {
+    // Oldest entry is first in iteration order
+    cache.delete(cache.keys().next().value as string);
+  }
+}
+
+/**
+ * Cached description, or undefined if it has not been loaded yet
+ */
+export function getCachedDescription(id: string): string | null | undefined {
+  const description = cache.get(id);
+  if (description !== undefined) {
+    remember(id, description); // Bump recency
+  }
+  return description;
+}
+
+// Read a block's descriptions into the cache
+async function loadBlockDescriptions(key: string): Promise<void> {
+  const [block, row] = await Promise.all([db.programBlocks.get(key), db.programDescriptions.get(key)]);
+  if (!block || !row) return;
+  const base = block.day * DAY_MS;
+  block.starts.forEach((start, i) => {
+    remember(`${block.stream_id}_${base + start * 1000}`, row.descriptions[i] || null);
+  });
+}
+
+/**
+ * Load a description from IndexedDB (concurrent requests for a block share one read)
+ */
+export async function loadProgramDescription(id: string): Promise<string | null> {
+  const cached = getCachedDescription(id);
+  if (cached !== undefined) return cached;
+
+  const key = blockKeyForProgramId(id);
+  let request = pending.get(key);
+  if (!request) {
+    request = loadBlockDescriptions(key).finally(() => pending.delete(key));
+    pending.set(key, request);
+  }
+  await request;
+
+  const description = getCachedDescription(id) ?? null;
+  remember(id, description);
+  return description;
+}
+
+/**
+ * Drop cached descriptions (after an EPG sync may have changed them)
+ */
+export function clearDescriptionCache(): void {
+  cache.clear();
+}
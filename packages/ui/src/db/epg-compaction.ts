@@ -0,0 +1,116 @@
+/**
+ * EPG retention and compaction
+ *
+ * Providers ship 7-14 days of guide data and programmes never expire on their
+ * own, so the guide is pruned to a retention window (default: 24h of history,
+ * 3 days ahead). The sync pipeline drops programmes outside the window before
+ * writing them; this job removes channel-day blocks that have since aged out.
+ * It works in whole days: a block goes once its day has passed the history
+ * cutoff, or when its day starts after the look-ahead cutoff.
+ *
+ * Deletes use the blocks' `day` index in small chunks scheduled with
+ * requestIdleCallback so pruning never competes with guide rendering.
+ */
+
+import { db } from './index';
+import { deleteProgramBlocks } from './epg-store';
+import { dayOf } from './program-blocks';
+import { waitForIdle } from './idle';
+
+export interface EpgRetention {
+  pastHours: number;   // History to keep behind now
+  futureDays: number;  // Guide data to keep ahead of now (0 = keep everything)
+}
+
+export const DEFAULT_EPG_RETENTION: EpgRetention = {
+  pastHours: 24,
+  futureDays: 3,
+};
+
+// Blocks deleted per idle slice
+const COMPACTION_CHUNK_SIZE = 500;
+// How often the background job re-runs while the app is open
+const COMPACTION_INTERVAL_MS = 60 * 60 * 1000;
+
+/**
+ * Time window (ms since epoch) that programmes must overlap to be kept
+ */
+export function getRetentionWindow(retention: EpgRetention, now: number = Date.now()): { from: number; to: number } {
+  return {
+    from: now - retention.pastHours * 60 * 60 * 1000,
+    to: retention.futureDays > 0 ? now + retention.futureDays * 24 * 60 * 60 * 1000 : Infinity,
+  };
+}
+
+/**
+ * Load the user's retention settings (renderer only - needs the storage bridge)
+ */
+export async function loadEpgRetention(): Promise<EpgRetention> {
+  if (!window.storage) return DEFAULT_EPG_RETENTION;
+  const result = await window.storage.getSettings();
+  return {
+    pastHours: result.data?.epgRetentionPastHours ?? DEFAULT_EPG_RETENTION.pastHours,
+    futureDays: result.data?.epgRetentionFutureDays ?? DEFAULT_EPG_RETENTION.futureDays,
+  };
+}
+
+/**
+ * Prune guide blocks outside the retention window.
+ * Returns the number of blocks deleted.
+ */
+export async function compactPrograms(retention: EpgRetention): Promise<number> {
+  const { from, to } = getRetentionWindow(retention);
+  let deleted = 0;
+
+  // Days that ended before the history cutoff
+  while (true) {
+    await waitForIdle();
+    const keys = await db.programBlocks.where('day').below(dayOf(from)).limit(COMPACTION_CHUNK_SIZE).primaryKeys();
+    if (keys.length === 0) break;
+    await deleteProgramBlocks(keys);
+    deleted += keys.length;
+  }
+
+  // Days starting beyond the look-ahead cutoff
+  if (Number.isFinite(to)) {
+    while (true) {
+      await waitForIdle();
+      const keys = await db.programBlocks.where('day').above(dayOf(to)).limit(COMPACTION_CHUNK_SIZE).primaryKeys();
+      if (keys.length === 0) break;
+      await deleteProgramBlocks(keys);
+      deleted += keys.length;
+    }
+  }
+
+  if (deleted > 0) {
+    console.log(`[EPG] Compaction removed ${deleted} guide blocks outside retention window`);
+  }
+  return deleted;
+}
+
+let compactionRunning = false;
+
+/**
+ * Run compaction with the current settings (skipped if a run is in progress)
+ */
+export async function runEpgCompaction(): Promise<void> {
+  if (compactionRunning) return;
+  compactionRunning = true;
+  try {
+    await compactPrograms(await loadEpgRetention());
+  } catch (err) {
+    console.error('[EPG] Compaction failed:', err);
+  } finally {
+    compactionRunning = false;
+  }
+}
+
+/**
+ * Start the periodic background compaction job.
+ * Returns a cleanup function for use in effects.
+ */
+export function startEpgCompaction(): () => void {
+  runEpgCompaction();
+  const timer = setInterval(runEpgCompaction, COMPACTION_INTERVAL_MS);
+  return () => clearInterval(timer);
+}
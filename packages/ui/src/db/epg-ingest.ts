@@ -0,0 +1,176 @@
+/**
+ * EPG ingestion pipeline: fetch → parse → map → IndexedDB write
+ *
+ * Runs inside the EPG worker (workers/epg.worker.ts) so the guide and the
+ * now playing bar stay responsive while a full XMLTV guide is processed.
+ * Only depends on Dexie and local-adapter, never on React or window state.
+ */
+
+import { getXtreamClient, fetchTextChunks, parseXmltvStream, type XmltvProgram } from '@sbtltv/local-adapter';
+import type { Source } from '@sbtltv/core';
+import { db } from './index';
+import { deleteProgramBlocks, writePrograms, type ProgramWithDescription } from './epg-store';
+import { blockKey, dayOf } from './program-blocks';
+import { DEFAULT_EPG_RETENTION, getRetentionWindow, type EpgRetention } from './epg-compaction';
+
+export interface EpgProgress {
+  sourceId: string;
+  parsed: number;   // Programmes read from the guide so far
+  stored: number;   // Programmes matched to a channel so far
+}
+
+export interface EpgIngestResult {
+  programCount: number;  // Programmes now stored for the source
+  written: number;       // New or changed channel-day blocks written
+  unchanged: number;     // Blocks left alone because their content matched
+  deleted: number;       // Blocks that vanished from the guide or expired
+}
+
+export interface EpgSyncOptions {
+  epgUrl?: string;           // External guide; omitted for the Xtream built-in guide
+  retention?: EpgRetention;  // Programmes outside this window are not stored
+}
+
+const BATCH_SIZE = 1000;
+// Programmes held back before their blocks are written
+const PENDING_PROGRAM_LIMIT = 20_000;
+
+const EMPTY_RESULT: EpgIngestResult = { programCount: 0, written: 0, unchanged: 0, deleted: 0 };
+
+// Build a map of epg_channel_id -> stream_id from the channels already stored for a source
+async function loadChannelMap(sourceId: string): Promise<Map<string, string>> {
+  const channelMap = new Map<string, string>();
+  await db.channels.where('source_id').equals(sourceId).each((ch) => {
+    if (ch.epg_channel_id) {
+      channelMap.set(ch.epg_channel_id, ch.stream_id);
+    }
+  });
+  return channelMap;
+}
+
+/**
+ * Guide URL for a source: an explicit XMLTV URL (M3U url-tvg or manual
+ * override), otherwise the Xtream built-in xmltv.php endpoint
+ */
+export function getGuideUrl(source: Source, epgUrl?: string): string | null {
+  if (epgUrl) return epgUrl;
+  return getXtreamClient(source)?.getEpgUrl() ?? null;
+}
+
+function streamGuide(source: Source, epgUrl?: string): AsyncIterable<XmltvProgram[]> | null {
+  const url = getGuideUrl(source, epgUrl);
+  return url ? parseXmltvStream(fetchTextChunks(url, 'EPG'), BATCH_SIZE) : null;
+}
+
+/**
+ * Ingest the XMLTV guide for a source.
+ * Plain and gzipped (.xml.gz) guides are both streamed and never fully buffered.
+ *
+ * Diff sync: programmes are packed into channel-day blocks, and a block is
+ * only written when it is new or its programmes or their content hashes
+ * changed. Blocks are written once enough programmes are pending, except
+ * those of the channel being read: guides list programmes channel by channel,
+ * so that one is probably not complete yet. A block whose channel comes back
+ * after it was written is merged with what this sync already stored for it.
+ * Once the whole guide has been read, blocks that were not seen (dropped
+ * by the provider, or outside the retention window) are deleted. Existing
+ * data is kept untouched if the guide yields nothing.
+ */
+export async function ingestEpg(
+  source: Source,
+  options: EpgSyncOptions = {},
+  onProgress?: (progress: EpgProgress) => void,
+  signal?: AbortSignal
+): Promise<EpgIngestResult> {
+  const guide = streamGuide(source, options.epgUrl);
+  if (!guide) return EMPTY_RESULT;
+
+  const channelMap = await loadChannelMap(source.id);
+  if (channelMap.size === 0) {
+    console.log('[EPG] No channels with EPG ids, skipping guide download');
+    return EMPTY_RESULT;
+  }
+
+  console.log('[EPG] Streaming XMLTV data...');
+  const { from, to } = getRetentionWindow(options.retention ?? DEFAULT_EPG_RETENTION);
+  const seen = new Set<string>();
+  // Programmes of blocks not written yet, and blocks written by this sync
+  const pending = new Map<string, ProgramWithDescription[]>();
+  const stored = new Set<string>();
+  let pendingCount = 0;
+  let parsedCount = 0;
+  let written = 0;
+  let unchanged = 0;
+
+  // Write pending blocks (all, or all but the given channel's)
+  const flush = async (keepStreamId?: string) => {
+    const replace: ProgramWithDescription[] = [];
+    const merge: ProgramWithDescription[] = [];
+    for (const [key, programs] of pending) {
+      if (programs[0].stream_id === keepStreamId) continue;
+      pending.delete(key);
+      pendingCount -= programs.length;
+      (stored.has(key) ? merge : replace).push(...programs);
+      stored.add(key);
+    }
+    for (const counts of [await writePrograms(replace, 'replace'), await writePrograms(merge, 'merge')]) {
+      written += counts.written;
+      unchanged += counts.unchanged;
+    }
+  };
+
+  for await (const batch of guide) {
+    if (signal?.aborted) {
+      throw new Error('EPG sync cancelled');
+    }
+    parsedCount += batch.length;
+
+    let lastStreamId: string | undefined;
+    for (const prog of batch) {
+      const streamId = channelMap.get(prog.channel_id);
+      if (!streamId) continue;
+      // Skip programmes outside the retention window
+      if (prog.stop.getTime() < from || prog.start.getTime() > to) continue;
+
+      const id = `${streamId}_${prog.start.getTime()}`;
+      if (seen.has(id)) continue;
+      seen.add(id);
+
+      const key = blockKey(streamId, dayOf(prog.start.getTime()));
+      const program: ProgramWithDescription = {
+        stream_id: streamId,
+        title: prog.title,
+        description: prog.description,
+        start: prog.start,
+        end: prog.stop,
+        source_id: source.id,
+      };
+      const programs = pending.get(key);
+      if (programs) programs.push(program);
+      else pending.set(key, [program]);
+      pendingCount++;
+      lastStreamId = streamId;
+    }
+
+    // The channel at the end of the batch probably continues in the next one
+    if (pendingCount >= PENDING_PROGRAM_LIMIT) await flush(lastStreamId);
+    onProgress?.({ sourceId: source.id, parsed: parsedCount, stored: seen.size });
+  }
+  await flush();
+
+  if (seen.size === 0) {
+    console.log('[EPG] No programs found, keeping existing data');
+    return EMPTY_RESULT;
+  }
+
+  // Remove blocks the provider dropped or that left the retention window
+  const existingKeys = await db.programBlocks.where('source_id').equals(source.id).primaryKeys();
+  const stale = existingKeys.filter((key) => !stored.has(key));
+  await deleteProgramBlocks(stale);
+
+  console.log(
+    `[EPG] Sync complete: ${seen.size} of ${parsedCount} programs mapped, ` +
+    `${written} blocks written, ${unchanged} unchanged, ${stale.length} deleted`
+  );
+  return { programCount: seen.size, written, unchanged, deleted: stale.length };
+}
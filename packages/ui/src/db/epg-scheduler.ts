@@ -0,0 +1,87 @@
+/**
+ * EPG auto-refresh scheduler
+ *
+ * Periodically refreshes the guide (not the channel lists) of sources whose
+ * EPG is older than the user's epgRefreshHours. Sources are processed one at
+ * a time with a pause in between so they don't all hit the network at once,
+ * and each refresh waits for an idle period first. Unchanged guides are
+ * detected with a HEAD request inside refreshSourceEpg and not downloaded.
+ */
+
+import type { Source } from '@sbtltv/core';
+import { isEpgStale, isSourceSyncInProgress, refreshSourceEpg } from './sync';
+import { waitForIdle } from './idle';
+
+// How often stale sources are looked for
+const CHECK_INTERVAL_MS = 15 * 60 * 1000;
+// First check after startup (startup sync has just refreshed everything)
+const INITIAL_DELAY_MS = 2 * 60 * 1000;
+// Pause between two sources in the same run
+const SOURCE_STAGGER_MS = 30 * 1000;
+
+const DEFAULT_EPG_REFRESH_HOURS = 6;
+
+let running = false;
+
+function delay(ms: number): Promise<void> {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+async function loadStaleSources(): Promise<Source[]> {
+  if (!window.storage) return [];
+  const [sourcesResult, settingsResult] = await Promise.all([
+    window.storage.getSources(),
+    window.storage.getSettings(),
+  ]);
+  const refreshHours = settingsResult.data?.epgRefreshHours ?? DEFAULT_EPG_REFRESH_HOURS;
+
+  const stale: Source[] = [];
+  for (const source of sourcesResult.data ?? []) {
+    if (source.enabled && await isEpgStale(source.id, refreshHours)) {
+      stale.push(source);
+    }
+  }
+  return stale;
+}
+
+/**
+ * Refresh every stale source's EPG once (skipped if a run is in progress)
+ */
+export async function runEpgRefresh(): Promise<void> {
+  if (running) return;
+  running = true;
+  try {
+    const sources = await loadStaleSources();
+    for (let i = 0; i < sources.length; i++) {
+      if (i > 0) await delay(SOURCE_STAGGER_MS);
+      await waitForIdle(10000);
+
+      // A full source sync refreshes the guide itself
+      if (isSourceSyncInProgress()) {
+        console.log('[EPG] Channel sync in progress, postponing scheduled refresh');
+        return;
+      }
+
+      const source = sources[i];
+      console.log('[EPG] Scheduled refresh for', source.name || source.id);
+      await refreshSourceEpg(source);
+    }
+  } catch (err) {
+    console.error('[EPG] Scheduled refresh failed:', err);
+  } finally {
+    running = false;
+  }
+}
+
+/**
+ * Start the background EPG refresh loop.
+ * Returns a cleanup function for use in effects.
+ */
+export function startEpgScheduler(): () => void {
+  const initial = setTimeout(runEpgRefresh, INITIAL_DELAY_MS);
+  const timer = setInterval(runEpgRefresh, CHECK_INTERVAL_MS);
+  return () => {
+    clearTimeout(initial);
+    clearInterval(timer);
+  };
+}
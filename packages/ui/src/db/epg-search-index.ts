@@ -0,0 +1,200 @@
+/**
+ * EPG search index format and matching
+ *
+ * Builds the epgSearch entry of a guide block and matches queries against
+ * entries. Kept free of Dexie so the EPG worker can build entries and the
+ * benchmark can run the same matching code outside a browser; the query
+ * side (what to read, caching) lives in epg-search.ts.
+ *
+ * An entry lists the block's distinct terms in sorted order and, for each
+ * term, the positions of the block's programmes that contain it. The last
+ * query word matches as a prefix, which is a contiguous run of the sorted
+ * terms.
+ */
+
+import type { EpgSearchEntry, ProgramSummary, StoredProgramBlock } from './index';
+import { DAY_MS, parseBlockKey, programAt } from './program-blocks';
+
+// Index at most this many distinct terms per programme (title terms first)
+const MAX_TERMS_PER_PROGRAM = 48;
+const MIN_TERM_LENGTH = 2;
+
+const STOP_WORDS = new Set([
+  'the', 'and', 'for', 'with', 'from', 'that', 'this', 'are', 'was', 'his', 'her',
+  'its', 'has', 'have', 'not', 'but', 'you', 'they', 'their', 'into', 'who', 'of',
+  'in', 'on', 'at', 'to', 'is', 'an', 'as', 'by', 'be', 'it', 'or',
+]);
+
+/**
+ * Lower-case, accent-folded word tokens of a text
+ */
+export function tokenize(text: string): string[] {
+  if (!text) return [];
+  return text
+    .toLowerCase()
+    .normalize('NFKD')
+    .replace(/[\u0300-\u036f]/g, '')
+    .split(/[^\p{L}\p{N}]+/u)
+    .filter((term) => term.length >= MIN_TERM_LENGTH && !STOP_WORDS.has(term));
+}
+
+/**
+ * Search entry for a block from its programme titles and descriptions
+ * (in block order)
+ */
+export function buildSearchEntry(block: StoredProgramBlock, descriptions: string[]): EpgSearchEntry {
+  const programsByTerm = new Map<string, number[]>();
+  for (let i = 0; i < block.starts.length; i++) {
+    const terms = new Set<string>();
+    for (const term of tokenize(block.titles[block.titleIndex[i]])) terms.add(term);
+    for (const term of tokenize(descriptions[i] ?? '')) {
+      if (terms.size >= MAX_TERMS_PER_PROGRAM) break;
+      terms.add(term);
+    }
+    for (const term of terms) {
+      const programs = programsByTerm.get(term);
+      if (programs) programs.push(i);
+      else programsByTerm.set(term, [i]);
+    }
+  }
+
+  const terms = [...programsByTerm.keys()].sort();
+  const offsets = new Uint32Array(terms.length + 1);
+  const postings = new Uint16Array(terms.reduce((sum, term) => sum + programsByTerm.get(term)!.length, 0));
+  terms.forEach((term, t) => {
+    const programs = programsByTerm.get(term)!;
+    postings.set(programs, offsets[t]);
+    offsets[t + 1] = offsets[t] + programs.length;
+  });
+
+  return { key: block.key, source_id: block.source_id, day: block.day, terms, offsets, postings };
+}
+
+// First position in sorted `terms` not below `value`
+function lowerBound(terms: string[], value: string): number {
+  let lo = 0;
+  let hi = terms.length;
+  while (lo < hi) {
+    const mid = (lo + hi) >>> 1;
+    if (terms[mid] < value) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * Positions of the programmes in an entry that contain every whole word and
+ * a term starting with `prefix`
+ */
+export function matchSearchEntry(entry: EpgSearchEntry, programCount: number, words: string[], prefix: string): number[] {
+  // Programmes reached by each group of terms, counted once per group
+  const counts = new Uint8Array(programCount);
+  const add = (t: number, group: number) => {
+    for (let p = entry.offsets[t]; p < entry.offsets[t + 1]; p++) {
+      if (counts[entry.postings[p]] === group) counts[entry.postings[p]] = group + 1;
+    }
+  };
+
+  let group = 0;
+  for (const word of words) {
+    const t = lowerBound(entry.terms, word);
+    if (entry.terms[t] !== word) return [];
+    add(t, group++);
+  }
+  const first = lowerBound(entry.terms, prefix);
+  if (first === entry.terms.length || !entry.terms[first].startsWith(prefix)) return [];
+  for (let t = first; t < entry.terms.length && entry.terms[t].startsWith(prefix); t++) {
+    add(t, group);
+  }
+  group++;
+
+  const matches: number[] = [];
+  counts.forEach((count, i) => {
+    if (count === group) matches.push(i);
+  });
+  return matches;
+}
+
+/**
+ * The `limit` earliest-starting programmes of the given blocks that match and
+ * are still airing at `now`, sorted by start. Blocks are best passed in day
+ * order: once `limit` matches are found, blocks of later days are skipped
+ * without matching.
+ */
+export function matchBlocks(
+  blocks: Iterable<{ entry: EpgSearchEntry; block: StoredProgramBlock }>,
+  words: string[],
+  prefix: string,
+  now: number,
+  limit: number
+): ProgramSummary[] {
+  // Best matches so far, sorted by start
+  const best: { start: number; block: StoredProgramBlock; index: number }[] = [];
+  const full = () => best.length >= limit;
+
+  for (const { entry, block } of blocks) {
+    const base = block.day * DAY_MS;
+    if (full() && base >= best[best.length - 1].start) continue;
+
+    // Positions come back in start order
+    for (const index of matchSearchEntry(entry, block.starts.length, words, prefix)) {
+      const start = base + block.starts[index] * 1000;
+      if (full() && start >= best[best.length - 1].start) break;
+      if (base + block.ends[index] * 1000 <= now) continue;
+
+      let at = best.length;
+      while (at > 0 && best[at - 1].start > start) at--;
+      best.splice(at, 0, { start, block, index });
+      if (best.length > limit) best.pop();
+    }
+  }
+  return best.map(({ block, index }) => programAt(block, index));
+}
+
+/**
+ * Search entries and blocks of a few days held in memory, so queries over
+ * the days people search most never touch IndexedDB. Terms are interned:
+ * every entry read from IndexedDB brings its own copies of common words.
+ */
+export class SearchWindow {
+  // Blocks by day, then key
+  private readonly days = new Map<number, Map<string, { entry: EpgSearchEntry; block: StoredProgramBlock }>>();
+  private readonly terms = new Map<string, string>();
+  readonly firstDay: number;
+  readonly lastDay: number;
+
+  constructor(firstDay: number, lastDay: number) {
+    this.firstDay = firstDay;
+    this.lastDay = lastDay;
+    for (let day = firstDay; day <= lastDay; day++) this.days.set(day, new Map());
+  }
+
+  covers(day: number): boolean {
+    return this.days.has(day);
+  }
+
+  /**
+   * Add or replace a block (ignored outside the window's days)
+   */
+  put(entry: EpgSearchEntry, block: StoredProgramBlock): void {
+    const blocks = this.days.get(block.day);
+    if (!blocks) return;
+    entry.terms = entry.terms.map((term) => {
+      const interned = this.terms.get(term);
+      if (interned !== undefined) return interned;
+      this.terms.set(term, term);
+      return term;
+    });
+    blocks.set(block.key, { entry, block });
+  }
+
+  delete(key: string): void {
+    this.days.get(parseBlockKey(key).day)?.delete(key);
+  }
+
+  search(words: string[], prefix: string, now: number, limit: number): ProgramSummary[] {
+    // Map iteration follows insertion order, which is ascending day
+    const days = [...this.days.values()];
+    return matchBlocks(days.flatMap((blocks) => [...blocks.values()]), words, prefix, now, limit);
+  }
+}
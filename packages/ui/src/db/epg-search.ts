@@ -0,0 +1,193 @@
+/**
+ * EPG full-text search
+ *
+ * Inverted index over programme titles and descriptions, kept in the
+ * epgSearch table with one entry per guide block (channel-day, see
+ * program-blocks.ts) under the block's key. Entries carry a multiEntry
+ * `terms` index, so IndexedDB maintains term -> blocks for us; the entry
+ * format and matching are in epg-search-index.ts.
+ *
+ * Almost every search is answered from yesterday, today and tomorrow, so the
+ * entries and blocks of those days are read once into memory and queries run
+ * there without touching IndexedDB or programmes that already ended. The
+ * window is dropped when a sync changes the guide and reloaded on the next
+ * search (or on a new day); local block writes (short EPG) patch it in place.
+ *
+ * Only when the window has fewer than `limit` results are later days read:
+ * the blocks holding the query's driving term (the longest whole word, or the
+ * prefix), a day at a time, until a day fills the limit. A term that rare in
+ * the window only reaches a few blocks.
+ */
+
+import { db, type EpgSearchEntry, type ProgramSummary, type StoredChannel, type StoredProgramBlock } from './index';
+import { dayOf, parseBlockKey } from './program-blocks';
+import { SearchWindow, matchBlocks, tokenize } from './epg-search-index';
+
+// Days after today held in memory (yesterday is always included)
+const WINDOW_DAYS_AHEAD = 1;
+// Blocks per read while going through a day beyond the window
+const SCAN_CHUNK_SIZE = 200;
+
+export interface EpgSearchHit {
+  program: ProgramSummary;
+  channel: StoredChannel | undefined;
+}
+
+// Current window: loading, or loaded and kept in step with local writes
+let searchWindow: { day: number; ready: Promise<SearchWindow>; loaded: SearchWindow | null } | null = null;
+// Bumped whenever results may have changed
+let version = 0;
+const listeners = new Set<() => void>();
+
+function changed(): void {
+  version++;
+  for (const listener of listeners) listener();
+}
+
+async function loadWindow(today: number): Promise<SearchWindow> {
+  const days = new SearchWindow(today - 1, today + WINDOW_DAYS_AHEAD);
+  const [entries, blocks] = await Promise.all([
+    db.epgSearch.where('day').between(days.firstDay, days.lastDay, true, true).toArray(),
+    db.programBlocks.where('day').between(days.firstDay, days.lastDay, true, true).toArray(),
+  ]);
+  const blocksByKey = new Map(blocks.map((block) => [block.key, block]));
+  for (const entry of entries) {
+    const block = blocksByKey.get(entry.key);
+    if (block) days.put(entry, block);
+  }
+  return days;
+}
+
+function getWindow(now: number): Promise<SearchWindow> {
+  const today = dayOf(now);
+  if (!searchWindow || searchWindow.day !== today) {
+    const current: NonNullable<typeof searchWindow> = { day: today, ready: loadWindow(today), loaded: null };
+    current.ready.then(
+      (days) => { current.loaded = days; },
+      () => { if (searchWindow === current) searchWindow = null; }
+    );
+    searchWindow = current;
+  }
+  return searchWindow.ready;
+}
+
+/**
+ * Start loading the in-memory window ahead of the first query
+ */
+export function warmSearchIndex(): void {
+  getWindow(Date.now()).catch((err) => console.warn('[EPG] Search index load failed:', err));
+}
+
+/**
+ * Drop the in-memory window (after a sync changed the guide)
+ */
+export function clearSearchIndex(): void {
+  searchWindow = null;
+  changed();
+}
+
+/**
+ * Apply blocks written in this context to the in-memory window
+ */
+export function updateSearchIndex(entries: EpgSearchEntry[], blocks: StoredProgramBlock[]): void {
+  if (!searchWindow || entries.length === 0) return;
+  // A load in flight may or may not have seen the write - start over
+  if (!searchWindow.loaded) {
+    clearSearchIndex();
+    return;
+  }
+  entries.forEach((entry, i) => searchWindow!.loaded!.put(entry, blocks[i]));
+  changed();
+}
+
+/**
+ * Remove deleted blocks from the in-memory window
+ */
+export function removeFromSearchIndex(keys: string[]): void {
+  if (!searchWindow || keys.length === 0) return;
+  if (!searchWindow.loaded) {
+    clearSearchIndex();
+    return;
+  }
+  for (const key of keys) searchWindow.loaded.delete(key);
+  changed();
+}
+
+/**
+ * Subscribe to search result changes (for useSyncExternalStore)
+ */
+export function subscribeSearchIndex(listener: () => void): () => void {
+  listeners.add(listener);
+  return () => listeners.delete(listener);
+}
+
+export function getSearchIndexVersion(): number {
+  return version;
+}
+
+/**
+ * Matches from the days after `lastDay`, in start order, until `limit`
+ */
+async function searchLaterDays(
+  words: string[],
+  prefix: string,
+  lastDay: number,
+  now: number,
+  limit: number
+): Promise<ProgramSummary[]> {
+  // Blocks holding the driving term: the longest whole word (usually the
+  // rarest), else the prefix, which spans several terms
+  const driver = words.length > 0 ? words.reduce((a, b) => (b.length > a.length ? b : a)) : null;
+  const keys = driver
+    ? await db.epgSearch.where('terms').equals(driver).primaryKeys()
+    : await db.epgSearch.where('terms').startsWith(prefix).primaryKeys();
+
+  const keysByDay = new Map<number, string[]>();
+  for (const key of new Set(keys)) {
+    const { day } = parseBlockKey(key);
+    if (day <= lastDay) continue;
+    const dayKeys = keysByDay.get(day);
+    if (dayKeys) dayKeys.push(key);
+    else keysByDay.set(day, [key]);
+  }
+
+  const programs: ProgramSummary[] = [];
+  for (const day of [...keysByDay.keys()].sort((a, b) => a - b)) {
+    const dayKeys = keysByDay.get(day)!;
+    const blocks: { entry: EpgSearchEntry; block: StoredProgramBlock }[] = [];
+    for (let i = 0; i < dayKeys.length; i += SCAN_CHUNK_SIZE) {
+      const chunk = dayKeys.slice(i, i + SCAN_CHUNK_SIZE);
+      const [entries, rows] = await Promise.all([db.epgSearch.bulkGet(chunk), db.programBlocks.bulkGet(chunk)]);
+      entries.forEach((entry, j) => {
+        const block = rows[j];
+        if (entry && block) blocks.push({ entry, block });
+      });
+    }
+    programs.push(...matchBlocks(blocks, words, prefix, now, limit - programs.length));
+    if (programs.length >= limit) break;
+  }
+  return programs;
+}
+
+/**
+ * Find upcoming (or currently airing) programmes matching every word of the
+ * query. The last word matches as a prefix so results update while typing.
+ * Results are ordered by start time.
+ */
+export async function searchPrograms(query: string, limit = 50): Promise<EpgSearchHit[]> {
+  const terms = [...new Set(tokenize(query))];
+  if (terms.length === 0) return [];
+
+  const prefix = terms[terms.length - 1];
+  const words = terms.slice(0, -1);
+  const now = Date.now();
+
+  const days = await getWindow(now);
+  const programs = days.search(words, prefix, now, limit);
+  if (programs.length < limit) {
+    programs.push(...await searchLaterDays(words, prefix, days.lastDay, now, limit - programs.length));
+  }
+
+  const channels = await db.channels.bulkGet(programs.map((p) => p.stream_id));
+  return programs.map((program, i) => ({ program, channel: channels[i] }));
+}
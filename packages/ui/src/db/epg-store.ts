@@ -0,0 +1,107 @@
+/**
+ * EPG storage helpers
+ *
+ * Single place where guide blocks are written and removed, so every path
+ * (guide ingest, short EPG, source deletion, compaction) keeps a block's
+ * descriptions row and search entry in step with it. Programmes are grouped
+ * into their channel-day blocks here; a block whose programmes and content
+ * hashes match the stored one is not rewritten.
+ */
+
+import { db, type EpgSearchEntry, type StoredProgramBlock, type StoredProgramDescriptions } from './index';
+import {
+  blockKey,
+  dayOf,
+  packProgramBlock,
+  parseBlockKey,
+  sameProgramBlock,
+  unpackProgramRows,
+  type ProgramWithDescription,
+} from './program-blocks';
+import { buildSearchEntry } from './epg-search-index';
+import { removeFromSearchIndex, updateSearchIndex } from './epg-search';
+
+export type { ProgramWithDescription } from './program-blocks';
+
+// Blocks per IndexedDB transaction
+const BLOCK_WRITE_CHUNK_SIZE = 200;
+
+export interface BlockWriteCounts {
+  written: number;    // Blocks created or changed
+  unchanged: number;  // Blocks already stored with the same content
+}
+
+/**
+ * Write programmes into their channel-day blocks.
+ * - 'merge' adds them to what is stored (a programme with the same start is
+ *   replaced), for partial updates like short EPG
+ * - 'replace' makes them the whole content of their blocks, for a full guide
+ */
+export async function writePrograms(
+  programs: ProgramWithDescription[],
+  mode: 'merge' | 'replace' = 'merge'
+): Promise<BlockWriteCounts> {
+  const counts: BlockWriteCounts = { written: 0, unchanged: 0 };
+  if (programs.length === 0) return counts;
+
+  const groups = new Map<string, ProgramWithDescription[]>();
+  for (const program of programs) {
+    const key = blockKey(program.stream_id, dayOf(program.start.getTime()));
+    const group = groups.get(key);
+    if (group) group.push(program);
+    else groups.set(key, [program]);
+  }
+
+  const keys = [...groups.keys()];
+  for (let i = 0; i < keys.length; i += BLOCK_WRITE_CHUNK_SIZE) {
+    const chunk = keys.slice(i, i + BLOCK_WRITE_CHUNK_SIZE);
+    const written = await db.transaction('rw', [db.programBlocks, db.programDescriptions, db.epgSearch], async () => {
+      const stored = await db.programBlocks.bulkGet(chunk);
+      const storedDescriptions = mode === 'merge' ? await db.programDescriptions.bulkGet(chunk) : [];
+
+      const blocks: StoredProgramBlock[] = [];
+      const descriptions: StoredProgramDescriptions[] = [];
+      const entries: EpgSearchEntry[] = [];
+      chunk.forEach((key, j) => {
+        const previous = stored[j];
+        let rows = groups.get(key)!;
+        if (mode === 'merge' && previous) {
+          rows = [...unpackProgramRows(previous, storedDescriptions[j]), ...rows];
+        }
+
+        const { streamId, day } = parseBlockKey(key);
+        const packed = packProgramBlock(streamId, day, rows);
+        if (previous && sameProgramBlock(previous, packed.block)) {
+          counts.unchanged++;
+          return;
+        }
+        blocks.push(packed.block);
+        descriptions.push(packed.descriptions);
+        entries.push(buildSearchEntry(packed.block, packed.descriptions.descriptions));
+      });
+
+      await db.programBlocks.bulkPut(blocks);
+      await db.programDescriptions.bulkPut(descriptions);
+      await db.epgSearch.bulkPut(entries);
+      return { blocks, entries };
+    });
+    counts.written += written.blocks.length;
+    updateSearchIndex(written.entries, written.blocks);
+  }
+  return counts;
+}
+
+/**
+ * Delete blocks with their descriptions and search entries
+ */
+export async function deleteProgramBlocks(keys: string[]): Promise<void> {
+  for (let i = 0; i < keys.length; i += BLOCK_WRITE_CHUNK_SIZE) {
+    const chunk = keys.slice(i, i + BLOCK_WRITE_CHUNK_SIZE);
+    await db.transaction('rw', [db.programBlocks, db.programDescriptions, db.epgSearch], async () => {
+      await db.programBlocks.bulkDelete(chunk);
+      await db.programDescriptions.bulkDelete(chunk);
+      await db.epgSearch.bulkDelete(chunk);
+    });
+    removeFromSearchIndex(chunk);
+  }
+}
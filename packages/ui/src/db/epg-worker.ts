@@ -0,0 +1,126 @@
+/**
+ * EPG worker client
+ *
+ * Owns the shared EPG worker, dispatches sync jobs to it and relays its
+ * fetch requests to the preload bridge. Falls back to running the pipeline
+ * inline when Web Workers are unavailable.
+ */
+
+import type { Source } from '@sbtltv/core';
+import { waitForStreamPort } from '@sbtltv/local-adapter';
+import { ingestEpg, type EpgIngestResult, type EpgProgress, type EpgSyncOptions } from './epg-ingest';
+import type { EpgWorkerEvent, EpgWorkerRequest } from '../workers/epg-protocol';
+
+interface EpgJob {
+  sourceId: string;
+  resolve: (result: EpgIngestResult) => void;
+  reject: (error: Error) => void;
+  onProgress?: (progress: EpgProgress) => void;
+}
+
+let worker: Worker | null = null;
+let nextJobId = 0;
+const jobs = new Map<number, EpgJob>();
+
+function send(request: EpgWorkerRequest): void {
+  worker?.postMessage(request);
+}
+
+async function handleFetchRequest(event: Extract<EpgWorkerEvent, { type: 'fetch' }>): Promise<void> {
+  const { requestId, method, args } = event;
+  // Streaming fetches deliver their body port to this window - pass it on
+  const streamId = method === 'fetchStream' || method === 'fetchJsonArray' ? (args[0] as string) : null;
+  const streamPort = streamId ? waitForStreamPort(streamId) : null;
+  try {
+    if (!window.fetchProxy) throw new Error('Fetch proxy unavailable');
+    const fn = window.fetchProxy[method] as (...fnArgs: unknown[]) => ReturnType<typeof window.fetchProxy.fetch>;
+    const result = await fn(...args);
+    send({ type: 'fetch-result', requestId, result });
+    if (streamId && streamPort && result.success) {
+      const port = await streamPort.port;
+      worker?.postMessage({ type: 'fetch-stream-port', streamId }, [port]);
+    } else {
+      streamPort?.dispose();
+    }
+  } catch (err) {
+    streamPort?.dispose();
+    send({ type: 'fetch-result', requestId, result: { success: false, error: err instanceof Error ? err.message : 'Fetch failed' } });
+  }
+}
+
+function handleMessage(event: MessageEvent<EpgWorkerEvent>): void {
+  const message = event.data;
+  if (message.type === 'fetch') {
+    handleFetchRequest(message);
+    return;
+  }
+
+  const job = jobs.get(message.jobId);
+  if (!job) return;
+
+  switch (message.type) {
+    case 'progress':
+      job.onProgress?.(message.progress);
+      break;
+    case 'done':
+      jobs.delete(message.jobId);
+      job.resolve(message.result);
+      break;
+    case 'error':
+      jobs.delete(message.jobId);
+      job.reject(new Error(message.error));
+      break;
+  }
+}
+
+function getWorker(): Worker | null {
+  if (worker) return worker;
+  if (typeof Worker === 'undefined') return null;
+
+  worker = new Worker(new URL('../workers/epg.worker.ts', import.meta.url), { type: 'module' });
+  worker.addEventListener('message', handleMessage);
+  worker.addEventListener('error', (event) => {
+    console.error('[EPG] Worker crashed:', event.message);
+    // Fail outstanding jobs and start a fresh worker on next use
+    for (const job of jobs.values()) {
+      job.reject(new Error(event.message || 'EPG worker crashed'));
+    }
+    jobs.clear();
+    worker?.terminate();
+    worker = null;
+  });
+  return worker;
+}
+
+/**
+ * Run the EPG pipeline for a source in the EPG worker.
+ * Resolves with the diff sync counts.
+ */
+export function runEpgSync(
+  source: Source,
+  options: EpgSyncOptions,
+  onProgress?: (progress: EpgProgress) => void
+): Promise<EpgIngestResult> {
+  const target = getWorker();
+  if (!target) {
+    return ingestEpg(source, options, onProgress);
+  }
+
+  const jobId = ++nextJobId;
+  return new Promise<EpgIngestResult>((resolve, reject) => {
+    jobs.set(jobId, { sourceId: source.id, resolve, reject, onProgress });
+    send({ type: 'sync', jobId, source, options, proxied: !!window.fetchProxy });
+  });
+}
+
+/**
+ * Cancel any running EPG job for a source (e.g. when the source is deleted),
+ * or every running job if no source is given
+ */
+export function cancelEpgSync(sourceId?: string): void {
+  for (const [jobId, job] of jobs) {
+    if (sourceId === undefined || job.sourceId === sourceId) {
+      send({ type: 'cancel', jobId });
+    }
+  }
+}
@@ -0,0 +1,155 @@
+/**
+ * Background series-episode prefetch
+ *
+ * Opening a series normally waits on a get_series_info round trip. This queue
+ * warms the episode cache ahead of time for series the user is likely to
+ * open: hovered cards first, then series visible in carousels, then recently
+ * opened series whose cached episodes have gone stale. Requests run a couple
+ * at a time, at most one per SOURCE_MIN_INTERVAL_MS per source, and only
+ * when the renderer is idle.
+ *
+ * seriesEpisodeFetches records when each series was fetched and last used;
+ * once more than MAX_CACHED_SERIES series have cached episodes, the least
+ * recently used ones are evicted.
+ */
+
+import type { Source } from '@sbtltv/core';
+import { db } from './index';
+import { syncSeriesEpisodes } from './sync';
+import { waitForIdle } from './idle';
+
+export type PrefetchPriority = 'hover' | 'visible' | 'recent';
+
+// Lower runs first
+const PRIORITY_RANK: Record<PrefetchPriority, number> = { hover: 0, visible: 1, recent: 2 };
+
+// Cached episodes younger than this are not re-fetched
+const EPISODE_CACHE_TTL_MS = 24 * 60 * 60 * 1000;
+// LRU budget: series whose episodes are kept
+const MAX_CACHED_SERIES = 500;
+// Parallel prefetch requests (all sources)
+const MAX_CONCURRENT_PREFETCHES = 2;
+// Minimum spacing of prefetch requests to one source
+const SOURCE_MIN_INTERVAL_MS = 1000;
+// Queue bound - the lowest-priority, oldest entries are dropped first
+const MAX_QUEUE_SIZE = 100;
+// Recently opened series considered for a refresh
+const RECENT_SERIES_COUNT = 10;
+
+// series_id -> priority rank (Map order = enqueue order within a rank)
+const queue = new Map<string, number>();
+const inFlightIds = new Set<string>();
+const nextSlotAt = new Map<string, number>();
+
+function delay(ms: number): Promise<void> {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+/**
+ * Queue series for episode prefetch. Already queued series move up if the
+ * new priority is higher.
+ */
+export function prefetchSeriesEpisodes(seriesIds: string[], priority: PrefetchPriority): void {
+  const rank = PRIORITY_RANK[priority];
+  for (const seriesId of seriesIds) {
+    if (inFlightIds.has(seriesId)) continue;
+    const queued = queue.get(seriesId);
+    if (queued !== undefined && queued <= rank) continue;
+    queue.delete(seriesId);
+    queue.set(seriesId, rank);
+  }
+
+  while (queue.size > MAX_QUEUE_SIZE) {
+    queue.delete(takeNext(true)!);
+  }
+  pump();
+}
+
+/**
+ * Queue the most recently opened series whose cached episodes are stale
+ */
+export async function prefetchRecentSeries(): Promise<void> {
+  const recent = await db.seriesEpisodeFetches.orderBy('last_used').reverse().limit(RECENT_SERIES_COUNT).toArray();
+  const staleBefore = Date.now() - EPISODE_CACHE_TTL_MS;
+  const stale = recent.filter((entry) => entry.fetched_at < staleBefore).map((entry) => entry.series_id);
+  if (stale.length > 0) prefetchSeriesEpisodes(stale, 'recent');
+}
+
+/**
+ * Mark a series' cached episodes as used (keeps them out of LRU eviction)
+ */
+export async function touchSeriesEpisodes(seriesId: string): Promise<void> {
+  await db.seriesEpisodeFetches.update(seriesId, { last_used: Date.now() });
+}
+
+// Highest-priority entry (or the lowest-priority one to drop when `last`)
+function takeNext(last = false): string | undefined {
+  let best: string | undefined;
+  let bestRank = last ? -1 : Infinity;
+  for (const [seriesId, rank] of queue) {
+    if (last ? rank > bestRank : rank < bestRank) {
+      best = seriesId;
+      bestRank = rank;
+    }
+  }
+  if (best !== undefined) queue.delete(best);
+  return best;
+}
+
+function pump(): void {
+  while (inFlightIds.size < MAX_CONCURRENT_PREFETCHES && queue.size > 0) {
+    const seriesId = takeNext()!;
+    inFlightIds.add(seriesId);
+    prefetch(seriesId)
+      .catch((err) => console.warn('[VOD Series] Episode prefetch failed for', seriesId, err))
+      .finally(() => {
+        inFlightIds.delete(seriesId);
+        pump();
+      });
+  }
+}
+
+async function isCached(seriesId: string): Promise<boolean> {
+  const fetch = await db.seriesEpisodeFetches.get(seriesId);
+  if (fetch) return Date.now() - fetch.fetched_at < EPISODE_CACHE_TTL_MS;
+  // Cached before fetches were logged
+  return (await db.vodEpisodes.where('series_id').equals(seriesId).count()) > 0;
+}
+
+async function loadSource(sourceId: string): Promise<Source | undefined> {
+  const result = await window.storage?.getSources();
+  return result?.data?.find((s) => s.id === sourceId && s.enabled);
+}
+
+// Wait for the source's next request slot (slots are reserved in call order)
+async function waitForSourceSlot(sourceId: string): Promise<void> {
+  const now = Date.now();
+  const slot = Math.max(now, nextSlotAt.get(sourceId) ?? 0);
+  nextSlotAt.set(sourceId, slot + SOURCE_MIN_INTERVAL_MS);
+  if (slot > now) await delay(slot - now);
+}
+
+async function prefetch(seriesId: string): Promise<void> {
+  const series = await db.vodSeries.get(seriesId);
+  if (!series || await isCached(seriesId)) return;
+
+  const source = await loadSource(series.source_id);
+  if (!source) return;
+
+  await waitForSourceSlot(source.id);
+  await waitForIdle();
+  await syncSeriesEpisodes(source, seriesId);
+  await enforceEpisodeBudget();
+}
+
+// Evict the least recently used series' episodes beyond the budget
+async function enforceEpisodeBudget(): Promise<void> {
+  const excess = (await db.seriesEpisodeFetches.count()) - MAX_CACHED_SERIES;
+  if (excess <= 0) return;
+
+  const ids = await db.seriesEpisodeFetches.orderBy('last_used').limit(excess).primaryKeys();
+  await db.transaction('rw', [db.vodEpisodes, db.seriesEpisodeFetches], async () => {
+    await db.vodEpisodes.where('series_id').anyOf(ids).delete();
+    await db.seriesEpisodeFetches.bulkDelete(ids);
+  });
+}
@@ -0,0 +1,14 @@
+/**
+ * Resolve when the renderer is idle (or after `timeout` ms at the latest).
+ * Background EPG jobs await this between units of work so they never compete
+ * with scrolling or playback UI.
+ */
+export function waitForIdle(timeout = 2000): Promise<void> {
+  return new Promise((resolve) => {
+    if (typeof requestIdleCallback === 'function') {
+      requestIdleCallback(() => resolve(), { timeout });
+    } else {
+      setTimeout(resolve, 0);
+    }
+  });
+}
@@ -17,6 +17,9 @@ export interface SourceMeta {
   source_id: string;
   epg_url?: string;
   last_synced?: Date;
+  epg_last_synced?: Date;       // Last successful guide refresh (or unchanged check)
+  epg_etag?: string;            // Guide validators from the last refresh
+  epg_last_modified?: string;
   vod_last_synced?: Date;
   channel_count: number;
   category_count: number;
@@ -64,15 +67,59 @@ export interface UserPrefs {
   value: string;
 }
 
-// EPG program entry
-export interface StoredProgram {
-  id: string; // `${stream_id}_${start}` compound key
+// Programme fields needed to draw the guide (no description)
+export interface ProgramSummary {
+  id: string; // `${stream_id}_${start}`
   stream_id: string;
   title: string;
-  description: string;
   start: Date;
   end: Date;
+}
+
+// Packed EPG block: all programmes of one channel starting on one UTC day.
+// Storage of record for the guide (see program-blocks.ts)
+export interface StoredProgramBlock {
+  key: string;             // `${stream_id}_${day}`
+  stream_id: string;
+  source_id: string;
+  day: number;             // UTC day number (ms / 86400000)
+  starts: Uint32Array;     // Start offsets in seconds from the start of the day, ascending
+  ends: Uint32Array;       // End offsets in seconds from the start of the day
+  titles: string[];        // Title string table
+  titleIndex: Uint16Array; // Per programme index into titles
+  hashes: Uint32Array;     // Per programme content hash (title/description/end) for diff sync
+}
+
+// Last on-demand short EPG fetch per channel (TTL cache, see short-epg.ts)
+export interface ShortEpgFetch {
+  stream_id: string;
+  source_id: string;
+  fetched_at: number; // ms since epoch
+}
+
+// Episode cache bookkeeping per series (see episode-prefetch.ts)
+export interface SeriesEpisodeFetch {
+  series_id: string;
   source_id: string;
+  fetched_at: number; // ms since epoch
+  last_used: number;  // Last fetch or open - the LRU budget evicts the oldest
+}
+
+// Full-text search entry for a block (see epg-search.ts)
+export interface EpgSearchEntry {
+  key: string;           // Block key
+  source_id: string;
+  day: number;
+  terms: string[];       // Distinct title/description words, sorted (multiEntry index)
+  offsets: Uint32Array;  // Postings of terms[i] are postings[offsets[i]..offsets[i + 1])
+  postings: Uint16Array; // Positions in the block of the programmes containing a term
+}
+
+// Programme descriptions of a block, fetched on demand
+export interface StoredProgramDescriptions {
+  id: string; // Block key
+  source_id: string;
+  descriptions: string[]; // In block order
 }
 
 class SbtltvDatabase extends Dexie {
@@ -80,10 +127,14 @@ class SbtltvDatabase extends Dexie {
   categories!: Table<StoredCategory, string>;
   sourcesMeta!: Table<SourceMeta, string>;
   prefs!: Table<UserPrefs, string>;
-  programs!: Table<StoredProgram, string>;
+  programBlocks!: Table<StoredProgramBlock, string>;
+  programDescriptions!: Table<StoredProgramDescriptions, string>;
+  shortEpgFetches!: Table<ShortEpgFetch, string>;
+  epgSearch!: Table<EpgSearchEntry, string>;
   vodMovies!: Table<StoredMovie, string>;
   vodSeries!: Table<StoredSeries, string>;
   vodEpisodes!: Table<StoredEpisode, string>;
+  seriesEpisodeFetches!: Table<SeriesEpisodeFetch, string>;
   vodCategories!: Table<VodCategory, string>;
 
   constructor() {
@@ -160,24 +211,96 @@ class SbtltvDatabase extends Dexie {
       vodEpisodes: 'id, series_id, season_num, episode_num',
       vodCategories: 'category_id, source_id, name, type',
     });
+
+    // Add packed per-channel-day EPG blocks and a description side table
+    this.version(7).stores({
+      channels: 'stream_id, source_id, *category_ids, name',
+      categories: 'category_id, source_id, category_name',
+      sourcesMeta: 'source_id',
+      prefs: 'key',
+      programs: 'id, stream_id, source_id, start, end, [stream_id+start]',
+      programBlocks: 'key, stream_id, source_id, day',
+      programDescriptions: 'id, source_id',
+      vodMovies: 'stream_id, source_id, *category_ids, name, tmdb_id, added, popularity, [source_id+tmdb_id]',
+      vodSeries: 'series_id, source_id, *category_ids, name, tmdb_id, added, popularity, [source_id+tmdb_id]',
+      vodEpisodes: 'id, series_id, season_num, episode_num',
+      vodCategories: 'category_id, source_id, name, type',
+    }).upgrade(async (tx) => {
+      // Blocks are built during EPG sync; drop the old rows so the startup sync
+      // re-downloads the guide and populates every table consistently
+      await tx.table('programs').clear();
+    });
+
+    // Descriptions are only kept in programDescriptions; strip the copies from programme rows
+    this.version(8).stores({}).upgrade(async (tx) => {
+      await tx.table('programs').toCollection().modify((program: { description?: string }) => {
+        delete program.description;
+      });
+    });
+
+    // Add short EPG fetch log for on-demand EPG sources
+    this.version(9).stores({
+      shortEpgFetches: 'stream_id, source_id',
+    });
+
+    // Add EPG full-text search index (filled by the re-index in version 12)
+    this.version(10).stores({
+      epgSearch: 'key, source_id, *terms',
+    });
+
+    // Add episode cache log for background episode prefetch
+    this.version(11).stores({
+      seriesEpisodeFetches: 'series_id, source_id, last_used',
+    });
+
+    // Blocks become the guide's storage of record: programme rows go away,
+    // descriptions and search entries are re-keyed per block. Every derived EPG
+    // table is rebuilt (and re-indexed) by the next guide sync.
+    this.version(12).stores({
+      programs: null,
+      epgSearch: 'key, source_id, day, *terms',
+    }).upgrade(async (tx) => {
+      for (const table of ['programBlocks', 'programDescriptions', 'epgSearch', 'shortEpgFetches']) {
+        await tx.table(table).clear();
+      }
+      // Forget guide sync times and validators so the next sync re-downloads the guide
+      await tx.table('sourcesMeta').toCollection().modify((meta: SourceMeta) => {
+        delete meta.epg_last_synced;
+        delete meta.epg_etag;
+        delete meta.epg_last_modified;
+      });
+    });
   }
 }
 
 export const db = new SbtltvDatabase();
 
 // Helper to clear all data for a source (before re-sync or on delete)
-export async function clearSourceData(sourceId: string): Promise<void> {
-  await db.transaction('rw', [db.channels, db.categories, db.sourcesMeta, db.programs], async () => {
+// keepPrograms: leave the guide in place for a diff-based EPG sync
+export async function clearSourceData(sourceId: string, options: { keepPrograms?: boolean } = {}): Promise<void> {
+  await db.transaction('rw', [db.channels, db.categories, db.sourcesMeta], async () => {
     await db.channels.where('source_id').equals(sourceId).delete();
     await db.categories.where('source_id').equals(sourceId).delete();
     await db.sourcesMeta.where('source_id').equals(sourceId).delete();
-    await db.programs.where('source_id').equals(sourceId).delete();
+  });
+  if (!options.keepPrograms) {
+    await clearSourcePrograms(sourceId);
+  }
+}
+
+// Helper to clear all EPG data (blocks, descriptions, search entries) for a source
+export async function clearSourcePrograms(sourceId: string): Promise<void> {
+  await db.transaction('rw', [db.programBlocks, db.programDescriptions, db.shortEpgFetches, db.epgSearch], async () => {
+    await db.programBlocks.where('source_id').equals(sourceId).delete();
+    await db.programDescriptions.where('source_id').equals(sourceId).delete();
+    await db.shortEpgFetches.where('source_id').equals(sourceId).delete();
+    await db.epgSearch.where('source_id').equals(sourceId).delete();
   });
 }
 
 // Helper to clear VOD data for a source
 export async function clearVodData(sourceId: string): Promise<void> {
-  await db.transaction('rw', [db.vodMovies, db.vodSeries, db.vodEpisodes, db.vodCategories], async () => {
+  await db.transaction('rw', [db.vodMovies, db.vodSeries, db.vodEpisodes, db.seriesEpisodeFetches, db.vodCategories], async () => {
     // Get series IDs BEFORE deleting them (episodes don't have source_id directly)
     const series = await db.vodSeries.where('source_id').equals(sourceId).toArray();
     const seriesIds = series.map(s => s.series_id);
@@ -189,6 +312,7 @@ export async function clearVodData(sourceId: string): Promise<void> {
     for (const seriesId of seriesIds) {
       await db.vodEpisodes.where('series_id').equals(seriesId).delete();
     }
+    await db.seriesEpisodeFetches.where('source_id').equals(sourceId).delete();
     await db.vodCategories.where('source_id').equals(sourceId).delete();
   });
 }
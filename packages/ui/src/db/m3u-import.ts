@@ -0,0 +1,124 @@
+/**
+ * M3U file import client
+ *
+ * Local playlists are streamed from disk by the main process and parsed in
+ * the M3U import worker (see workers/m3u-import.worker.ts). Only summaries
+ * and progress cross back to the UI thread; the parsed channels wait in the
+ * worker until commitM3UImport writes them.
+ */
+
+import type { M3UImportWorkerEvent, M3UImportWorkerRequest } from '../workers/m3u-import-protocol';
+
+export interface M3UImportSummary {
+  channelCount: number;
+  categoryCount: number;
+  epgUrl: string | null;
+}
+
+export interface M3UImportProgress {
+  bytes: number;
+  channels: number;
+}
+
+interface ImportJob {
+  resolve: (summary: M3UImportSummary) => void;
+  reject: (error: Error) => void;
+  onProgress?: (progress: M3UImportProgress) => void;
+}
+
+let worker: Worker | null = null;
+const jobs = new Map<string, ImportJob>();
+
+function send(request: M3UImportWorkerRequest, transfer: Transferable[] = []): void {
+  getWorker().postMessage(request, transfer);
+}
+
+function handleMessage(event: MessageEvent<M3UImportWorkerEvent>): void {
+  const message = event.data;
+  const job = jobs.get(message.importId);
+  if (!job) return;
+
+  switch (message.type) {
+    case 'progress':
+      job.onProgress?.({ bytes: message.bytes, channels: message.channels });
+      break;
+    case 'parsed':
+    case 'committed':
+      jobs.delete(message.importId);
+      job.resolve(message.summary);
+      break;
+    case 'error':
+      jobs.delete(message.importId);
+      job.reject(new Error(message.error));
+      break;
+  }
+}
+
+function getWorker(): Worker {
+  if (worker) return worker;
+  worker = new Worker(new URL('../workers/m3u-import.worker.ts', import.meta.url), { type: 'module' });
+  worker.addEventListener('message', handleMessage);
+  worker.addEventListener('error', (event) => {
+    console.error('[M3U] Import worker crashed:', event.message);
+    for (const job of jobs.values()) {
+      job.reject(new Error(event.message || 'M3U import worker crashed'));
+    }
+    jobs.clear();
+    worker?.terminate();
+    worker = null;
+  });
+  return worker;
+}
+
+function run(importId: string, request: M3UImportWorkerRequest, transfer: Transferable[] = [], onProgress?: ImportJob['onProgress']): Promise<M3UImportSummary> {
+  return new Promise<M3UImportSummary>((resolve, reject) => {
+    jobs.set(importId, { resolve, reject, onProgress });
+    send(request, transfer);
+  });
+}
+
+// Wait for the preload bridge to relay the file port for an import
+function receiveFilePort(importId: string): Promise<MessagePort> {
+  return new Promise((resolve) => {
+    const onMessage = (event: MessageEvent) => {
+      if (event.source !== window || event.data?.type !== 'm3u-import-port' || event.data.importId !== importId) return;
+      window.removeEventListener('message', onMessage);
+      resolve(event.ports[0]);
+    };
+    window.addEventListener('message', onMessage);
+  });
+}
+
+/**
+ * Stream and parse a file picked with window.storage.importM3UFile().
+ * Channels are parsed for `sourceId`, the id the source will be saved under.
+ */
+export async function parseM3UImport(
+  importId: string,
+  sourceId: string,
+  onProgress?: (progress: M3UImportProgress) => void
+): Promise<M3UImportSummary> {
+  if (!window.storage) throw new Error('Storage API not available');
+
+  const port = receiveFilePort(importId);
+  const result = await window.storage.streamM3UImport(importId);
+  if (result.error) throw new Error(result.error);
+
+  const filePort = await port;
+  return run(importId, { type: 'parse', importId, sourceId, port: filePort }, [filePort], onProgress);
+}
+
+/**
+ * Store a parsed import's channels and categories
+ */
+export function commitM3UImport(importId: string): Promise<M3UImportSummary> {
+  return run(importId, { type: 'commit', importId });
+}
+
+/**
+ * Drop a parsed import that won't be saved
+ */
+export function discardM3UImport(importId: string): void {
+  jobs.delete(importId);
+  worker?.postMessage({ type: 'discard', importId } satisfies M3UImportWorkerRequest);
+}
@@ -0,0 +1,171 @@
+/**
+ * Packed EPG blocks
+ *
+ * One record per (stream_id, UTC day) instead of one per programme. Start and
+ * end times are stored as second offsets in typed arrays and titles go into a
+ * per-block string table (repeats like "News" are stored once), so the guide
+ * grid reads a handful of compact records instead of thousands of objects.
+ *
+ * Blocks are the storage of record for the guide. A block's descriptions
+ * (programDescriptions) and search entry (epgSearch) share its key and list
+ * programmes in the same order, so a channel-day costs three rows however
+ * many programmes it has. Per-programme content hashes in the block let a
+ * sync skip rewriting channel-days that did not change.
+ */
+
+import type { ProgramSummary, StoredProgramBlock, StoredProgramDescriptions } from './index';
+
+export const DAY_MS = 24 * 60 * 60 * 1000;
+
+// Programme as parsed from a guide, before it is packed into a block
+export interface ProgramWithDescription {
+  stream_id: string;
+  title: string;
+  description: string;
+  start: Date;
+  end: Date;
+  source_id: string;
+}
+
+export function dayOf(ms: number): number {
+  return Math.floor(ms / DAY_MS);
+}
+
+export function blockKey(streamId: string, day: number): string {
+  return `${streamId}_${day}`;
+}
+
+/**
+ * Block key for a programme id (`${stream_id}_${startMs}`)
+ */
+export function blockKeyForProgramId(programId: string): string {
+  const sep = programId.lastIndexOf('_');
+  return blockKey(programId.slice(0, sep), dayOf(Number(programId.slice(sep + 1))));
+}
+
+/**
+ * Split a block key back into stream id and day
+ */
+export function parseBlockKey(key: string): { streamId: string; day: number } {
+  const sep = key.lastIndexOf('_');
+  return { streamId: key.slice(0, sep), day: Number(key.slice(sep + 1)) };
+}
+
+/**
+ * FNV-1a hash of the fields that make a programme "changed" between syncs.
+ * start is the programme's identity within its block, so it is not hashed.
+ */
+export function hashProgram(title: string, description: string, end: Date): number {
+  const input = `${title}\u0000${description}\u0000${end.getTime()}`;
+  let hash = 0x811c9dc5;
+  for (let i = 0; i < input.length; i++) {
+    hash ^= input.charCodeAt(i);
+    hash = Math.imul(hash, 0x01000193);
+  }
+  return hash >>> 0;
+}
+
+/**
+ * Pack a channel's programmes for one day. Rows must share stream_id and day;
+ * of several rows with the same start the last one wins.
+ */
+export function packProgramBlock(
+  streamId: string,
+  day: number,
+  rows: ProgramWithDescription[]
+): { block: StoredProgramBlock; descriptions: StoredProgramDescriptions } {
+  const byStart = new Map<number, ProgramWithDescription>();
+  for (const row of rows) byStart.set(row.start.getTime(), row);
+  const sorted = [...byStart.values()].sort((a, b) => a.start.getTime() - b.start.getTime());
+
+  const base = day * DAY_MS;
+  const starts = new Uint32Array(sorted.length);
+  const ends = new Uint32Array(sorted.length);
+  const hashes = new Uint32Array(sorted.length);
+  const titleIndex = new Uint16Array(sorted.length);
+  const titles: string[] = [];
+  const titleLookup = new Map<string, number>();
+
+  sorted.forEach((row, i) => {
+    starts[i] = Math.round((row.start.getTime() - base) / 1000);
+    ends[i] = Math.max(starts[i], Math.round((row.end.getTime() - base) / 1000));
+    hashes[i] = hashProgram(row.title, row.description, row.end);
+
+    let index = titleLookup.get(row.title);
+    if (index === undefined) {
+      index = titles.length;
+      titles.push(row.title);
+      titleLookup.set(row.title, index);
+    }
+    titleIndex[i] = index;
+  });
+
+  const key = blockKey(streamId, day);
+  const sourceId = sorted[0]?.source_id ?? '';
+  return {
+    block: { key, stream_id: streamId, source_id: sourceId, day, starts, ends, titles, titleIndex, hashes },
+    descriptions: { id: key, source_id: sourceId, descriptions: sorted.map((row) => row.description) },
+  };
+}
+
+/**
+ * Do two blocks hold the same programmes with the same content?
+ */
+export function sameProgramBlock(a: StoredProgramBlock, b: StoredProgramBlock): boolean {
+  if (a.source_id !== b.source_id || a.starts.length !== b.starts.length) return false;
+  for (let i = 0; i < a.starts.length; i++) {
+    if (a.starts[i] !== b.starts[i] || a.hashes[i] !== b.hashes[i]) return false;
+  }
+  return true;
+}
+
+/**
+ * Programmes of a stored block with their descriptions, for merging new
+ * programmes into it
+ */
+export function unpackProgramRows(
+  block: StoredProgramBlock,
+  descriptions: StoredProgramDescriptions | undefined
+): ProgramWithDescription[] {
+  const base = block.day * DAY_MS;
+  return Array.from(block.starts, (start, i) => ({
+    stream_id: block.stream_id,
+    title: block.titles[block.titleIndex[i]],
+    description: descriptions?.descriptions[i] ?? '',
+    start: new Date(base + start * 1000),
+    end: new Date(base + block.ends[i] * 1000),
+    source_id: block.source_id,
+  }));
+}
+
+/**
+ * Programme at position `i` of a block
+ */
+export function programAt(block: StoredProgramBlock, i: number): ProgramSummary {
+  const base = block.day * DAY_MS;
+  const startMs = base + block.starts[i] * 1000;
+  return {
+    id: `${block.stream_id}_${startMs}`,
+    stream_id: block.stream_id,
+    title: block.titles[block.titleIndex[i]],
+    start: new Date(startMs),
+    end: new Date(base + block.ends[i] * 1000),
+  };
+}
+
+/**
+ * Unpack the programmes of a block that overlap [fromMs, toMs)
+ */
+export function unpackProgramBlock(block: StoredProgramBlock, fromMs: number, toMs: number): ProgramSummary[] {
+  const base = block.day * DAY_MS;
+  const result: ProgramSummary[] = [];
+
+  for (let i = 0; i < block.starts.length; i++) {
+    const startMs = base + block.starts[i] * 1000;
+    if (startMs >= toMs) break; // starts are ascending
+    const endMs = base + block.ends[i] * 1000;
+    if (endMs <= fromMs) continue;
+    result.push(programAt(block, i));
+  }
+  return result;
+}
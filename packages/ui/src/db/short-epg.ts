@@ -0,0 +1,133 @@
+/**
+ * On-demand EPG (Xtream get_short_epg)
+ *
+ * For sources with epg_mode 'on_demand' the full XMLTV download is skipped.
+ * Instead the guide asks for short EPG of the channels Virtuoso is currently
+ * rendering. Requests are debounced, deduplicated, limited to a few at a time
+ * and skipped while a channel's last fetch (shortEpgFetches) is within the TTL.
+ * Results go through the normal EPG store so blocks and descriptions stay in
+ * step with full-guide sources.
+ */
+
+import { getXtreamClient } from '@sbtltv/local-adapter';
+import type { Source } from '@sbtltv/core';
+import { db, type StoredChannel } from './index';
+import { writePrograms, type ProgramWithDescription } from './epg-store';
+
+// How long a channel's short EPG is considered fresh
+const SHORT_EPG_TTL_MS = 30 * 60 * 1000;
+// Parallel get_short_epg requests
+const MAX_CONCURRENT_REQUESTS = 4;
+// Programmes requested per channel (covers the guide's look-ahead)
+const SHORT_EPG_LIMIT = 12;
+// Wait for scrolling to settle before requesting
+const REQUEST_DEBOUNCE_MS = 150;
+
+let sourcesPromise: Promise<Map<string, Source>> | null = null;
+
+// Channels waiting for a request slot, and ids queued or in flight (dedup)
+let queue: StoredChannel[] = [];
+const queuedIds = new Set<string>();
+const inFlightIds = new Set<string>();
+let debounceTimer: ReturnType<typeof setTimeout> | null = null;
+
+function loadOnDemandSources(): Promise<Map<string, Source>> {
+  if (!sourcesPromise) {
+    sourcesPromise = (async () => {
+      const result = await window.storage?.getSources();
+      const sources = new Map<string, Source>();
+      for (const source of result?.data ?? []) {
+        if (source.enabled && source.type === 'xtream' && source.epg_mode === 'on_demand' && source.username && source.password) {
+          sources.set(source.id, source);
+        }
+      }
+      return sources;
+    })();
+  }
+  return sourcesPromise;
+}
+
+/**
+ * Forget cached source settings (call when sources are edited or re-synced)
+ */
+export function invalidateShortEpgSources(): void {
+  sourcesPromise = null;
+}
+
+async function fetchChannel(channel: StoredChannel, source: Source): Promise<void> {
+  try {
+    const programs = await getXtreamClient(source)!.getShortEpgPrograms(channel.stream_id, SHORT_EPG_LIMIT);
+    const rows: ProgramWithDescription[] = programs.map((prog) => ({
+      stream_id: channel.stream_id,
+      title: prog.title,
+      description: prog.description,
+      start: prog.start,
+      end: prog.stop,
+      source_id: source.id,
+    }));
+    // A short EPG is a slice of the guide, so it is merged into the stored blocks
+    await writePrograms(rows, 'merge');
+  } catch (err) {
+    // Still recorded below so a failing channel is retried after the TTL, not on every scroll
+    console.warn('[EPG] Short EPG failed for', channel.stream_id, err);
+  }
+  await db.shortEpgFetches.put({ stream_id: channel.stream_id, source_id: source.id, fetched_at: Date.now() });
+}
+
+async function pump(): Promise<void> {
+  const sources = await loadOnDemandSources();
+  while (inFlightIds.size < MAX_CONCURRENT_REQUESTS && queue.length > 0) {
+    const channel = queue.shift()!;
+    queuedIds.delete(channel.stream_id);
+    const source = sources.get(channel.source_id);
+    if (!source) continue;
+
+    inFlightIds.add(channel.stream_id);
+    fetchChannel(channel, source).finally(() => {
+      inFlightIds.delete(channel.stream_id);
+      pump();
+    });
+  }
+}
+
+async function enqueue(channels: StoredChannel[]): Promise<void> {
+  const sources = await loadOnDemandSources();
+  if (sources.size === 0) return;
+
+  // Only the latest viewport matters - drop channels that scrolled away
+  const visibleIds = new Set(channels.map((ch) => ch.stream_id));
+  queue = queue.filter((ch) => {
+    if (visibleIds.has(ch.stream_id)) return true;
+    queuedIds.delete(ch.stream_id);
+    return false;
+  });
+
+  const candidates = channels.filter(
+    (ch) => sources.has(ch.source_id) && !queuedIds.has(ch.stream_id) && !inFlightIds.has(ch.stream_id)
+  );
+  if (candidates.length === 0) return;
+
+  const fetches = await db.shortEpgFetches.bulkGet(candidates.map((ch) => ch.stream_id));
+  const now = Date.now();
+  candidates.forEach((channel, i) => {
+    const last = fetches[i];
+    if (last && now - last.fetched_at < SHORT_EPG_TTL_MS) return;
+    if (queuedIds.has(channel.stream_id)) return;
+    queuedIds.add(channel.stream_id);
+    queue.push(channel);
+  });
+
+  await pump();
+}
+
+/**
+ * Request short EPG for the channels currently shown in the guide.
+ * Channels from sources not in on-demand mode are ignored.
+ */
+export function requestShortEpg(channels: StoredChannel[]): void {
+  if (debounceTimer) clearTimeout(debounceTimer);
+  debounceTimer = setTimeout(() => {
+    debounceTimer = null;
+    enqueue(channels).catch((err) => console.error('[EPG] Short EPG request failed:', err));
+  }, REQUEST_DEBOUNCE_MS);
+}
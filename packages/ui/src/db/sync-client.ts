@@ -0,0 +1,134 @@
+/**
+ * Sync daemon client
+ *
+ * UI-window side of the sync daemon (see sync-daemon.ts): sends sync
+ * requests over the daemon's port and mirrors its progress into this
+ * window's uiStore. Without the Electron bridge (plain browser) there is no
+ * daemon and the same work runs in this window.
+ */
+
+import { useUIStore } from '../stores/uiStore';
+import { cancelSync as cancelLocalSync, markSourceDeleted, type SyncChange, type SyncResult, type VodSyncResult } from './sync';
+import { clearDescriptionCache } from './description-cache';
+import { clearSearchIndex } from './epg-search';
+import { startSyncSchedule, syncSources, syncVod } from './sync-daemon';
+import type { SyncDaemonEvent, SyncDaemonRequest } from './sync-daemon-protocol';
+
+interface PendingRequest {
+  resolve: (results: Map<string, SyncResult> | Map<string, VodSyncResult>) => void;
+  reject: (error: Error) => void;
+}
+
+let port: MessagePort | null = null;
+let portWaiters: ((port: MessagePort) => void)[] = [];
+let nextRequestId = 0;
+const pending = new Map<number, PendingRequest>();
+
+function hasDaemon(): boolean {
+  return !!window.syncDaemon;
+}
+
+function applyChange(change: SyncChange): void {
+  // Live queries pick up the rows by themselves; only in-memory caches need dropping
+  if (change.scope === 'epg') clearDescriptionCache();
+  // Removed channels take their guide blocks with them
+  if (change.scope === 'epg' || change.scope === 'channels') clearSearchIndex();
+}
+
+function handleEvent(event: MessageEvent<SyncDaemonEvent>): void {
+  const message = event.data;
+  switch (message.type) {
+    case 'state':
+      useUIStore.setState(message.state);
+      break;
+    case 'changed':
+      applyChange(message.change);
+      break;
+    case 'done':
+    case 'error': {
+      const request = pending.get(message.requestId);
+      if (!request) return;
+      pending.delete(message.requestId);
+      if (message.type === 'done') request.resolve(message.results);
+      else request.reject(new Error(message.error));
+    }
+  }
+}
+
+function handleWindowMessage(event: MessageEvent): void {
+  if (event.source !== window || event.data?.type !== 'sync-daemon-port' || !event.ports[0]) return;
+
+  // A new port means the daemon (or this window) was restarted - requests
+  // sent over the old one will never be answered
+  for (const request of pending.values()) {
+    request.reject(new Error('Sync daemon restarted'));
+  }
+  pending.clear();
+
+  port?.close();
+  port = event.ports[0];
+  port.onmessage = handleEvent;
+  for (const resolve of portWaiters) resolve(port);
+  portWaiters = [];
+}
+
+function getPort(): Promise<MessagePort> {
+  if (port) return Promise.resolve(port);
+  return new Promise((resolve) => portWaiters.push(resolve));
+}
+
+async function send(request: SyncDaemonRequest): Promise<void> {
+  (await getPort()).postMessage(request);
+}
+
+function request<T>(type: 'sync-sources' | 'sync-vod', sourceId?: string): Promise<T> {
+  const requestId = ++nextRequestId;
+  return new Promise<T>((resolve, reject) => {
+    pending.set(requestId, { resolve: resolve as PendingRequest['resolve'], reject });
+    send({ type, requestId, sourceId });
+  });
+}
+
+/**
+ * Connect to the sync daemon, or start the sync schedule in this window if
+ * there is none. Returns a cleanup function for use in effects.
+ */
+export function startBackgroundSync(): () => void {
+  if (!hasDaemon()) return startSyncSchedule();
+
+  window.addEventListener('message', handleWindowMessage);
+  window.syncDaemon!.connect('ui');
+  return () => window.removeEventListener('message', handleWindowMessage);
+}
+
+/**
+ * Sync channels and EPG of one source (forced), or of all enabled sources
+ */
+export function requestSourceSync(sourceId?: string): Promise<Map<string, SyncResult>> {
+  return hasDaemon() ? request('sync-sources', sourceId) : syncSources(sourceId);
+}
+
+/**
+ * Sync the VOD catalog of one Xtream source, or of all of them
+ */
+export function requestVodSync(sourceId?: string): Promise<Map<string, VodSyncResult>> {
+  return hasDaemon() ? request('sync-vod', sourceId) : syncVod(sourceId);
+}
+
+/**
+ * Stop running syncs (data stored so far is kept)
+ */
+export function cancelSync(): void {
+  if (hasDaemon()) send({ type: 'cancel' });
+  else cancelLocalSync();
+}
+
+/**
+ * Tell running syncs a source is being deleted, so they stop writing its data.
+ * Call before clearing the source's data.
+ */
+export function notifySourceDeleted(sourceId: string): void {
+  // Also drops this window's cached Xtream client for the source
+  markSourceDeleted(sourceId);
+  if (hasDaemon()) send({ type: 'source-deleted', sourceId });
+}
@@ -0,0 +1,31 @@
+/**
+ * Message protocol between the UI window and the sync daemon window
+ */
+
+import type { EpgProgress } from './epg-ingest';
+import type { CatalogProgress } from './catalog-sync';
+import type { SyncChange, SyncResult, VodSyncResult } from './sync';
+
+// The daemon's sync fields of the uiStore, mirrored into the UI window's store
+export interface SyncDaemonState {
+  channelSyncing: boolean;
+  vodSyncing: boolean;
+  tmdbMatching: boolean;
+  epgProgress: EpgProgress | null;
+  catalogProgress: Record<string, CatalogProgress>;
+}
+
+// UI → daemon
+// sourceId: sync only this source (forced, ignoring staleness); all enabled sources otherwise
+export type SyncDaemonRequest =
+  | { type: 'sync-sources'; requestId: number; sourceId?: string }
+  | { type: 'sync-vod'; requestId: number; sourceId?: string }
+  | { type: 'cancel' }
+  | { type: 'source-deleted'; sourceId: string };
+
+// Daemon → UI
+export type SyncDaemonEvent =
+  | { type: 'state'; state: SyncDaemonState }
+  | { type: 'changed'; change: SyncChange }
+  | { type: 'done'; requestId: number; results: Map<string, SyncResult> | Map<string, VodSyncResult> }
+  | { type: 'error'; requestId: number; error: string };
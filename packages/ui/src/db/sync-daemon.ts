@@ -0,0 +1,180 @@
+/**
+ * Background sync daemon
+ *
+ * The main process runs a hidden window (index.html#sync-daemon) that owns
+ * all sync work: the startup sync, the EPG refresh scheduler, EPG compaction
+ * and manual syncs requested from Settings. Guide imports and catalog syncs
+ * therefore never compete with the UI window's main thread, and keep running
+ * while the UI reloads.
+ *
+ * The UI window talks to the daemon over a MessagePort set up by the main
+ * process (see sync-client.ts). Both windows share the IndexedDB database, so
+ * Dexie live queries in the UI see written rows on their own; the port
+ * carries requests, progress (the uiStore sync fields) and change
+ * notifications for the UI's in-memory caches.
+ */
+
+import type { Source } from '@sbtltv/core';
+import { useUIStore } from '../stores/uiStore';
+import {
+  syncAllSources, syncSource, syncAllVod, isVodStale, cancelSync, markSourceDeleted, onSyncChange,
+  type SyncResult, type VodSyncResult,
+} from './sync';
+import { startEpgCompaction } from './epg-compaction';
+import { startEpgScheduler } from './epg-scheduler';
+import { mirrorSyncChange } from './catalog-mirror';
+import type { SyncDaemonEvent, SyncDaemonRequest, SyncDaemonState } from './sync-daemon-protocol';
+
+const DEFAULT_VOD_REFRESH_HOURS = 24;
+
+// Running syncs per kind - the uiStore flag stays set until all of them finish
+const running = { channels: 0, vod: 0 };
+
+async function tracked<T>(kind: keyof typeof running, run: () => Promise<T>): Promise<T> {
+  const update = () => {
+    const store = useUIStore.getState();
+    if (kind === 'channels') store.setChannelSyncing(running.channels > 0);
+    else store.setVodSyncing(running.vod > 0);
+  };
+  running[kind]++;
+  update();
+  try {
+    return await run();
+  } finally {
+    running[kind]--;
+    update();
+  }
+}
+
+async function findSource(sourceId: string): Promise<Source> {
+  const result = await window.storage?.getSources();
+  const source = result?.data?.find((s) => s.id === sourceId);
+  if (!source) throw new Error('Source not found');
+  return source;
+}
+
+/**
+ * Sync the channels and EPG of one source (regardless of staleness), or of
+ * all enabled sources
+ */
+export function syncSources(sourceId?: string): Promise<Map<string, SyncResult>> {
+  return tracked('channels', async () => {
+    if (!sourceId) return syncAllSources();
+    const source = await findSource(sourceId);
+    return new Map([[source.id, await syncSource(source)]]);
+  });
+}
+
+/**
+ * Sync the VOD catalog of one Xtream source, or of all of them
+ */
+export function syncVod(sourceId?: string): Promise<Map<string, VodSyncResult>> {
+  return tracked('vod', async () => syncAllVod(sourceId ? [await findSource(sourceId)] : undefined));
+}
+
+// Sync all sources, then VOD for Xtream sources older than vodRefreshHours
+async function runStartupSync(): Promise<void> {
+  if (!window.storage) return;
+  const result = await window.storage.getSources();
+  if (!result.data || result.data.length === 0) return;
+
+  await syncSources();
+
+  const settingsResult = await window.storage.getSettings();
+  const vodRefreshHours = settingsResult.data?.vodRefreshHours ?? DEFAULT_VOD_REFRESH_HOURS;
+
+  const stale: Source[] = [];
+  for (const source of result.data.filter((s) => s.type === 'xtream' && s.enabled)) {
+    if (await isVodStale(source.id, vodRefreshHours)) {
+      console.log(`[VOD] Source ${source.name} is stale, syncing...`);
+      stale.push(source);
+    } else {
+      console.log(`[VOD] Source ${source.name} is fresh, skipping sync`);
+    }
+  }
+  if (stale.length > 0) {
+    await tracked('vod', () => syncAllVod(stale));
+  }
+}
+
+/**
+ * Start the scheduled sync work: startup sync, EPG refresh for sources older
+ * than epgRefreshHours and EPG compaction, plus copying synced catalogs to
+ * the SQLite backend. Runs in the daemon, or in the UI window when there is
+ * no daemon. Returns a cleanup function.
+ */
+export function startSyncSchedule(): () => void {
+  const stopMirror = onSyncChange(mirrorSyncChange);
+  runStartupSync().catch((err) => console.error('[Sync] Startup sync failed:', err));
+  const stopCompaction = startEpgCompaction();
+  const stopScheduler = startEpgScheduler();
+  return () => {
+    stopMirror();
+    stopCompaction();
+    stopScheduler();
+  };
+}
+
+function syncState(): SyncDaemonState {
+  const { channelSyncing, vodSyncing, tmdbMatching, epgProgress, catalogProgress } = useUIStore.getState();
+  return { channelSyncing, vodSyncing, tmdbMatching, epgProgress, catalogProgress };
+}
+
+// Port to the UI window (replaced when the UI reloads)
+let port: MessagePort | null = null;
+
+function post(event: SyncDaemonEvent): void {
+  port?.postMessage(event);
+}
+
+async function handleRequest(request: SyncDaemonRequest): Promise<void> {
+  switch (request.type) {
+    case 'cancel':
+      cancelSync();
+      return;
+    case 'source-deleted':
+      markSourceDeleted(request.sourceId);
+      return;
+    case 'sync-sources':
+    case 'sync-vod':
+      try {
+        const results = request.type === 'sync-sources'
+          ? await syncSources(request.sourceId)
+          : await syncVod(request.sourceId);
+        post({ type: 'done', requestId: request.requestId, results });
+      } catch (err) {
+        post({ type: 'error', requestId: request.requestId, error: err instanceof Error ? err.message : 'Sync failed' });
+      }
+  }
+}
+
+/**
+ * Daemon entry point (sync daemon window only)
+ */
+export function startSyncDaemon(): void {
+  window.addEventListener('message', (event: MessageEvent) => {
+    if (event.source !== window || event.data?.type !== 'sync-daemon-port' || !event.ports[0]) return;
+    port?.close();
+    port = event.ports[0];
+    port.onmessage = (e: MessageEvent<SyncDaemonRequest>) => handleRequest(e.data);
+    // A (re)connected UI starts from the current progress
+    post({ type: 'state', state: syncState() });
+  });
+
+  useUIStore.subscribe((state, prev) => {
+    if (
+      state.channelSyncing !== prev.channelSyncing ||
+      state.vodSyncing !== prev.vodSyncing ||
+      state.tmdbMatching !== prev.tmdbMatching ||
+      state.epgProgress !== prev.epgProgress ||
+      state.catalogProgress !== prev.catalogProgress
+    ) {
+      post({ type: 'state', state: syncState() });
+    }
+  });
+  onSyncChange((change) => post({ type: 'changed', change }));
+
+  window.syncDaemon?.connect('daemon');
+  startSyncSchedule();
+  console.log('[Sync Daemon] Started');
+}
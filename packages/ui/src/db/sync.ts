@@ -1,14 +1,29 @@
-import { db, clearSourceData, clearVodData, type SourceMeta, type StoredProgram, type StoredMovie, type StoredSeries, type StoredEpisode, type VodCategory } from './index';
-import { fetchAndParseM3U, XtreamClient } from '@sbtltv/local-adapter';
+import { db, clearSourceData, clearSourcePrograms, clearVodData, type SourceMeta, type StoredMovie, type StoredSeries, type StoredEpisode, type VodCategory } from './index';
+import { fetchM3UBatches, fetchResourceValidators, getXtreamClient, invalidateXtreamClient, type ResourceValidators } from '@sbtltv/local-adapter';
 import type { Source, Channel, Category, Movie, Series } from '@sbtltv/core';
 import { getEnrichedMovieExports, getEnrichedTvExports, findBestMatch, extractMatchParams } from '../services/tmdb-exports';
 import { useUIStore } from '../stores/uiStore';
+import { runEpgSync, cancelEpgSync } from './epg-worker';
+import { getGuideUrl, type EpgIngestResult } from './epg-ingest';
+import { loadEpgRetention } from './epg-compaction';
+import { clearDescriptionCache } from './description-cache';
+import { clearSearchIndex } from './epg-search';
+import { ChannelSyncSession } from './channel-store';
+import { fetchLiveByCategory, syncVodMoviesByCategory, syncVodSeriesByCategory } from './catalog-sync';
+import { invalidateShortEpgSources } from './short-epg';
 
 export interface SyncResult {
   success: boolean;
   channelCount: number;
   categoryCount: number;
   programCount: number;
+  // Channel diff sync counts
+  channelsWritten?: number;
+  channelsDeleted?: number;
+  // EPG diff sync counts in channel-day blocks (IndexedDB write volume)
+  epgBlocksWritten?: number;
+  epgBlocksUnchanged?: number;
+  epgBlocksDeleted?: number;
   epgUrl?: string;
   error?: string;
 }
@@ -32,6 +47,8 @@ const deletedSourceIds = new Set<string>();
 
 export function markSourceDeleted(sourceId: string) {
   deletedSourceIds.add(sourceId);
+  cancelEpgSync(sourceId);
+  invalidateXtreamClient(sourceId);
   // Clean up after 30 seconds (sync should be done by then)
   setTimeout(() => deletedSourceIds.delete(sourceId), 30000);
 }
@@ -40,6 +57,43 @@ function isSourceDeleted(sourceId: string): boolean {
   return deletedSourceIds.has(sourceId);
 }
 
+// Bumped by cancelSync() - a sync is cancelled once this differs from the
+// value it started with
+let syncGeneration = 0;
+
+/**
+ * Stop running syncs at their next checkpoint (between sources, between
+ * playlist batches, EPG jobs immediately). Unlike a deletion, data stored
+ * before the cancel is kept.
+ */
+export function cancelSync(): void {
+  syncGeneration++;
+  cancelEpgSync();
+}
+
+export interface SyncChange {
+  sourceId: string;
+  scope: 'channels' | 'epg' | 'vod';
+  // More writes to the same scope follow as part of this sync (e.g. TMDB
+  // matching after a VOD sync); consumers that copy data can wait for them
+  partial?: boolean;
+}
+
+const changeListeners = new Set<(change: SyncChange) => void>();
+
+/**
+ * Subscribe to data written by syncs (used to forward changes from the sync
+ * daemon to the UI window). Returns an unsubscribe function.
+ */
+export function onSyncChange(listener: (change: SyncChange) => void): () => void {
+  changeListeners.add(listener);
+  return () => changeListeners.delete(listener);
+}
+
+function emitChange(sourceId: string, scope: SyncChange['scope'], partial?: boolean): void {
+  for (const listener of changeListeners) listener({ sourceId, scope, partial });
+}
+
 // Reference counter for concurrent TMDB matching operations
 // Prevents race condition where Source A finishing sets tmdbMatching=false
 // while Source B is still running
@@ -60,69 +114,106 @@ function endTmdbMatching() {
 }
 
 // Sync EPG for all channels from a source using XMLTV
-async function syncEpgForSource(source: Source, channels: Channel[]): Promise<number> {
-  if (!source.username || !source.password) return 0;
+// epgUrl: external guide (M3U url-tvg or manual override), otherwise Xtream's built-in guide
+// The fetch/parse/store pipeline runs in the EPG worker (see epg-worker.ts)
+async function syncEpgForSource(source: Source, epgUrl?: string): Promise<EpgIngestResult | null> {
+  if (!epgUrl && (!source.username || !source.password)) return null;
 
-  console.log('[EPG] Starting sync for source:', source.name || source.id);
-
-  const client = new XtreamClient(
-    { baseUrl: source.url, username: source.username, password: source.password },
-    source.id
-  );
+  console.log('[EPG] Starting sync for source:', source.name || source.id, epgUrl ? `(${epgUrl})` : '');
+  const { setEpgProgress } = useUIStore.getState();
 
   try {
-    // Fetch full XMLTV data FIRST (don't delete old data until we have new)
-    console.log('[EPG] Fetching XMLTV data...');
-    const xmltvPrograms = await client.getXmltvEpg();
-    console.log('[EPG] Received', xmltvPrograms.length, 'programs from XMLTV');
-
-    if (xmltvPrograms.length === 0) {
-      console.log('[EPG] No programs found, keeping existing data');
-      return 0;
+    const retention = await loadEpgRetention();
+    const result = await runEpgSync(source, { epgUrl, retention }, setEpgProgress);
+    if (result.written > 0 || result.deleted > 0) {
+      clearDescriptionCache();
+      clearSearchIndex();
+      emitChange(source.id, 'epg');
     }
+    return result;
+  } catch (err) {
+    console.error('[EPG] Sync failed:', err);
+    return null;
+  } finally {
+    setEpgProgress(null);
+  }
+}
 
-    // Build a map of epg_channel_id -> stream_id for matching
-    const channelMap = new Map<string, string>();
-    for (const ch of channels) {
-      if (ch.epg_channel_id) {
-        channelMap.set(ch.epg_channel_id, ch.stream_id);
-      }
-    }
+// Number of full source syncs running (the EPG scheduler waits for them)
+let activeSourceSyncs = 0;
 
-    // Convert XMLTV programs to stored format
-    const storedPrograms: StoredProgram[] = [];
-
-    for (const prog of xmltvPrograms) {
-      const streamId = channelMap.get(prog.channel_id);
-      if (streamId) {
-        storedPrograms.push({
-          id: `${streamId}_${prog.start.getTime()}`,
-          stream_id: streamId,
-          title: prog.title,
-          description: prog.description,
-          start: prog.start,
-          end: prog.stop,
-          source_id: source.id,
-        });
-      }
-    }
+export function isSourceSyncInProgress(): boolean {
+  return activeSourceSyncs > 0;
+}
 
-    // Only clear old data after successful fetch
-    await db.programs.where('source_id').equals(source.id).delete();
+// Where a source's guide comes from
+// guide: XMLTV download (url undefined = Xtream built-in endpoint)
+type EpgTarget = { mode: 'guide'; url?: string } | { mode: 'on_demand' } | { mode: 'none' };
 
-    // Store in batches
-    const BATCH_SIZE = 1000;
-    for (let i = 0; i < storedPrograms.length; i += BATCH_SIZE) {
-      const batch = storedPrograms.slice(i, i + BATCH_SIZE);
-      await db.programs.bulkPut(batch);
-    }
+// m3uEpgUrl: url-tvg from the playlist header (M3U sources)
+function resolveEpgTarget(source: Source, m3uEpgUrl?: string): EpgTarget {
+  const shouldLoadEpg = source.auto_load_epg ?? (source.type === 'xtream');
 
-    console.log('[EPG] Sync complete:', storedPrograms.length, 'programs stored');
-    return storedPrograms.length;
-  } catch (err) {
-    console.error('[EPG] Fetch failed, keeping existing data:', err);
-    return 0;
+  if (shouldLoadEpg && source.type === 'xtream' && source.epg_mode === 'on_demand') {
+    return { mode: 'on_demand' };
+  }
+  if (shouldLoadEpg && source.type === 'xtream' && source.username && source.password) {
+    // Xtream: use built-in EPG endpoint
+    return { mode: 'guide' };
+  }
+  if (shouldLoadEpg && source.type === 'm3u' && m3uEpgUrl) {
+    // M3U with EPG URL: fetch XMLTV from the url-tvg header
+    return { mode: 'guide', url: m3uEpgUrl };
+  }
+  if (!shouldLoadEpg && source.epg_url) {
+    // User provided a manual EPG URL override
+    return { mode: 'guide', url: source.epg_url };
+  }
+  return { mode: 'none' };
+}
+
+// ETag / Last-Modified of a source's guide, null when unknown
+async function fetchGuideValidators(source: Source, epgUrl?: string): Promise<ResourceValidators | null> {
+  const guideUrl = getGuideUrl(source, epgUrl);
+  return guideUrl ? fetchResourceValidators(guideUrl).catch(() => null) : null;
+}
+
+/**
+ * Refresh only the EPG of a source (channels are left alone).
+ * Skips the download when the guide's ETag / Last-Modified match the last refresh.
+ * Returns null if nothing was synced (no guide, unchanged, or failed).
+ */
+export async function refreshSourceEpg(source: Source): Promise<EpgIngestResult | null> {
+  const meta = await db.sourcesMeta.get(source.id);
+  if (!meta || meta.error) return null; // Channels never synced - nothing to map the guide onto
+
+  const target = resolveEpgTarget(source, source.type === 'm3u' ? meta.epg_url : undefined);
+  if (target.mode !== 'guide') {
+    // Nothing to download; checked, so the scheduler doesn't pick it up again
+    await db.sourcesMeta.update(source.id, { epg_last_synced: new Date() });
+    return null;
+  }
+
+  const validators = await fetchGuideValidators(source, target.url);
+  const unchanged = !!validators && (
+    (!!validators.etag && validators.etag === meta.epg_etag) ||
+    (!validators.etag && !!validators.lastModified && validators.lastModified === meta.epg_last_modified)
+  );
+  if (unchanged) {
+    console.log('[EPG] Guide unchanged, skipping refresh for', source.name || source.id);
+    await db.sourcesMeta.update(source.id, { epg_last_synced: new Date() });
+    return null;
   }
+
+  const result = await syncEpgForSource(source, target.url);
+  if (result && !isSourceDeleted(source.id)) {
+    await db.sourcesMeta.update(source.id, {
+      epg_last_synced: new Date(),
+      epg_etag: validators?.etag,
+      epg_last_modified: validators?.lastModified,
+    });
+  }
+  return result;
 }
 
 // Check if EPG needs refresh
@@ -131,11 +222,13 @@ export async function isEpgStale(sourceId: string, refreshHours: number = DEFAUL
   // 0 means manual-only, never consider stale for auto-refresh
   if (refreshHours === 0) return false;
 
+  // Only a guide that was actually stored counts: a full sync whose guide
+  // failed must not make it look fresh
   const meta = await db.sourcesMeta.get(sourceId);
-  if (!meta?.last_synced) return true;
+  if (!meta?.epg_last_synced) return true;
 
   const staleMs = refreshHours * 60 * 60 * 1000;
-  return Date.now() - meta.last_synced.getTime() > staleMs;
+  return Date.now() - meta.epg_last_synced.getTime() > staleMs;
 }
 
 // Check if VOD needs refresh
@@ -153,44 +246,66 @@ export async function isVodStale(sourceId: string, refreshHours: number = DEFAUL
 
 // Sync a single source - fetches data and stores in Dexie
 export async function syncSource(source: Source): Promise<SyncResult> {
+  activeSourceSyncs++;
+  try {
+    return await runSourceSync(source);
+  } finally {
+    activeSourceSyncs--;
+  }
+}
+
+async function runSourceSync(source: Source): Promise<SyncResult> {
+  // Source settings (e.g. epg_mode) may have changed
+  invalidateShortEpgSources();
+  const generation = syncGeneration;
+
   try {
-    // Clear existing data for this source first
-    await clearSourceData(source.id);
+    // Channels are diffed against the stored list rather than cleared:
+    // unchanged channels (and their guide data) are not touched
+    const channelSync = new ChannelSyncSession(source.id);
 
     let channels: Channel[] = [];
     let categories: Category[] = [];
+    let keepUnseenChannels = false;
     let epgUrl: string | undefined;
 
     if (source.type === 'm3u') {
-      // M3U source - fetch and parse
-      const result = await fetchAndParseM3U(source.url, source.id);
-      channels = result.channels;
-      categories = result.categories;
-      epgUrl = result.epgUrl ?? undefined;
+      // M3U source - parse while downloading and store each batch right away,
+      // so the first categories are browsable before the playlist is complete
+      for await (const batch of fetchM3UBatches(source.url, source.id)) {
+        if (isSourceDeleted(source.id) || syncGeneration !== generation) break;
+        await channelSync.apply(batch.channels, batch.categories);
+        epgUrl = batch.epgUrl ?? undefined;
+      }
     } else if (source.type === 'xtream') {
       // Xtream source - use client
-      if (!source.username || !source.password) {
+      const client = getXtreamClient(source);
+      if (!client) {
         throw new Error('Xtream source requires username and password');
       }
 
-      const client = new XtreamClient(
-        {
-          baseUrl: source.url,
-          username: source.username,
-          password: source.password,
-        },
-        source.id
-      );
-
-      // Test connection first
+      // Test connection first (answered from the client's auth cache when recent)
       const connTest = await client.testConnection();
       if (!connTest.success) {
         throw new Error(connTest.error ?? 'Connection failed');
       }
+      const skewMs = client.getClockSkewMs();
+      if (Math.abs(skewMs) > 60_000) {
+        console.warn(`[Sync] ${source.name}: server clock is off by ${Math.round(skewMs / 1000)}s`);
+      }
 
       // Fetch categories and channels
-      categories = await client.getLiveCategories();
-      channels = await client.getLiveStreams();
+      if (source.fetch_by_category) {
+        // Per category, stored as each one arrives
+        const fetched = await fetchLiveByCategory(source, client, channelSync);
+        if (!fetched.complete) {
+          console.warn(`[Sync] ${fetched.failed} live categories failed, keeping channels not seen this sync`);
+          keepUnseenChannels = true;
+        }
+      } else {
+        categories = await client.getLiveCategories();
+        channels = await client.getLiveStreams();
+      }
 
       // Get server info for EPG URL if available
       if (connTest.info?.server_info) {
@@ -205,53 +320,81 @@ export async function syncSource(source: Source): Promise<SyncResult> {
     // Check if source was deleted during sync
     if (isSourceDeleted(source.id)) {
       console.log(`[Sync] Source ${source.id} was deleted during sync, skipping write`);
+      // Drop batches stored before the deletion was noticed
+      await clearSourceData(source.id);
       return { success: false, channelCount: 0, categoryCount: 0, programCount: 0, error: 'Source deleted' };
     }
 
-    // Store channels and categories in Dexie
-    await db.transaction('rw', [db.channels, db.categories, db.sourcesMeta], async () => {
-      if (channels.length > 0) {
-        await db.channels.bulkPut(channels);
-      }
-      if (categories.length > 0) {
-        await db.categories.bulkPut(categories);
-      }
+    // Cancelled: keep the previous channel list (and any batches already stored)
+    if (syncGeneration !== generation) {
+      console.log(`[Sync] Sync of ${source.id} cancelled`);
+      return { success: false, channelCount: 0, categoryCount: 0, programCount: 0, error: 'Sync cancelled' };
+    }
 
-      // Store sync metadata
-      const meta: SourceMeta = {
-        source_id: source.id,
-        epg_url: epgUrl,
-        last_synced: new Date(),
-        channel_count: channels.length,
-        category_count: categories.length,
-      };
-      await db.sourcesMeta.put(meta);
-    });
+    // Store channels and categories in Dexie (M3U batches are already stored),
+    // then drop whatever the provider no longer lists
+    await channelSync.apply(channels, categories);
+    const channelChanges = await channelSync.finish({ removeVanished: !keepUnseenChannels });
+    console.log(
+      `[Sync] ${source.name || source.id}: ${channelChanges.written} channels written, ` +
+      `${channelChanges.unchanged} unchanged, ${channelChanges.deleted} removed`
+    );
+    if (channelChanges.written > 0 || channelChanges.deleted > 0) {
+      clearSearchIndex();
+      emitChange(source.id, 'channels');
+    }
 
-    // Fetch EPG if enabled
-    let programCount = 0;
-    const shouldLoadEpg = source.auto_load_epg ?? (source.type === 'xtream');
-
-    if (shouldLoadEpg && source.type === 'xtream' && source.username && source.password) {
-      // Xtream: use built-in EPG endpoint (or override if provided)
-      programCount = await syncEpgForSource(source, channels);
-    } else if (shouldLoadEpg && epgUrl) {
-      // M3U with EPG URL: fetch XMLTV from the EPG URL
-      // TODO: Implement XMLTV fetch for M3U sources
-      console.log('[EPG] M3U EPG URL detected:', epgUrl);
+    // Store sync metadata, keeping the guide's sync time and validators
+    const previous = await db.sourcesMeta.get(source.id);
+    const meta: SourceMeta = {
+      ...previous,
+      source_id: source.id,
+      epg_url: epgUrl,
+      last_synced: new Date(),
+      channel_count: channelSync.channelCount,
+      category_count: channelSync.categoryCount,
+      error: undefined,
+    };
+    if (previous?.epg_url !== epgUrl) {
+      // Validators of another guide URL say nothing about this one
+      meta.epg_etag = undefined;
+      meta.epg_last_modified = undefined;
     }
+    await db.sourcesMeta.put(meta);
 
-    // If user provided a manual EPG URL override, use that instead
-    if (source.epg_url && !shouldLoadEpg) {
-      // TODO: Implement manual XMLTV fetch
-      console.log('[EPG] Manual EPG URL override:', source.epg_url);
+    // Fetch EPG if enabled
+    let epg: EpgIngestResult | null = null;
+    const target = resolveEpgTarget(source, epgUrl);
+
+    if (target.mode === 'on_demand') {
+      // On-demand EPG: no XMLTV download, the guide fetches short EPG for visible channels
+      console.log('[EPG] On-demand mode, skipping XMLTV download for', source.name || source.id);
+    } else if (target.mode === 'guide') {
+      // Validators let the scheduler skip the next refresh if the guide is unchanged
+      const validators = await fetchGuideValidators(source, target.url);
+      epg = await syncEpgForSource(source, target.url);
+      if (epg && !isSourceDeleted(source.id)) {
+        await db.sourcesMeta.update(source.id, {
+          epg_last_synced: new Date(),
+          epg_etag: validators?.etag,
+          epg_last_modified: validators?.lastModified,
+        });
+      }
+    } else {
+      // EPG disabled for this source - drop any guide left from earlier syncs
+      await clearSourcePrograms(source.id);
     }
 
     return {
       success: true,
-      channelCount: channels.length,
-      categoryCount: categories.length,
-      programCount,
+      channelCount: channelSync.channelCount,
+      categoryCount: channelSync.categoryCount,
+      channelsWritten: channelChanges.written,
+      channelsDeleted: channelChanges.deleted,
+      programCount: epg?.programCount ?? 0,
+      epgBlocksWritten: epg?.written,
+      epgBlocksUnchanged: epg?.unchanged,
+      epgBlocksDeleted: epg?.deleted,
       epgUrl,
     };
   } catch (error) {
@@ -259,11 +402,14 @@ export async function syncSource(source: Source): Promise<SyncResult> {
 
     // Don't write error if source was deleted during sync
     if (!isSourceDeleted(source.id)) {
+      // Channels from the previous sync are kept, so keep their counts too
+      const previous = await db.sourcesMeta.get(source.id);
       await db.sourcesMeta.put({
+        ...previous,
         source_id: source.id,
         last_synced: new Date(),
-        channel_count: 0,
-        category_count: 0,
+        channel_count: previous?.channel_count ?? 0,
+        category_count: previous?.category_count ?? 0,
         error: errorMsg,
       });
     } else {
@@ -297,7 +443,9 @@ export async function syncAllSources(): Promise<Map<string, SyncResult>> {
   }
 
   // Sync each enabled source
+  const generation = syncGeneration;
   for (const source of sourcesResult.data) {
+    if (syncGeneration !== generation) break;
     if (source.enabled) {
       console.log(`Syncing source: ${source.name} (${source.type})`);
       const result = await syncSource(source);
@@ -321,14 +469,14 @@ export async function getSyncStatus(): Promise<SourceMeta[]> {
 // Sync VOD movies for a single Xtream source
 // Uses safe update pattern: fetch new data first, only update if successful
 export async function syncVodMovies(source: Source): Promise<{ count: number; categoryCount: number; skipped?: boolean }> {
-  if (source.type !== 'xtream' || !source.username || !source.password) {
+  const client = getXtreamClient(source);
+  if (!client) {
     return { count: 0, categoryCount: 0 };
   }
 
-  const client = new XtreamClient(
-    { baseUrl: source.url, username: source.username, password: source.password },
-    source.id
-  );
+  if (source.fetch_by_category) {
+    return syncVodMoviesByCategory(source, client);
+  }
 
   // Fetch categories and movies FIRST (before any deletes)
   let categories;
@@ -405,14 +553,14 @@ export async function syncVodMovies(source: Source): Promise<{ count: number; ca
 // Sync VOD series for a single Xtream source
 // Uses safe update pattern: fetch new data first, only update if successful
 export async function syncVodSeries(source: Source): Promise<{ count: number; categoryCount: number; skipped?: boolean }> {
-  if (source.type !== 'xtream' || !source.username || !source.password) {
+  const client = getXtreamClient(source);
+  if (!client) {
     return { count: 0, categoryCount: 0 };
   }
 
-  const client = new XtreamClient(
-    { baseUrl: source.url, username: source.username, password: source.password },
-    source.id
-  );
+  if (source.fetch_by_category) {
+    return syncVodSeriesByCategory(source, client);
+  }
 
   // Fetch categories and series FIRST (before any deletes)
   let categories;
@@ -461,7 +609,7 @@ export async function syncVodSeries(source: Source): Promise<{ count: number; ca
   // Store in batches - use bulkPut to upsert (no delete needed)
   const BATCH_SIZE = 500;
 
-  await db.transaction('rw', [db.vodSeries, db.vodCategories, db.vodEpisodes], async () => {
+  await db.transaction('rw', [db.vodSeries, db.vodCategories, db.vodEpisodes, db.seriesEpisodeFetches], async () => {
     // Replace categories atomically (delete old, insert new)
     await db.vodCategories.where('source_id').equals(source.id).filter(c => c.type === 'series').delete();
     if (vodCategories.length > 0) {
@@ -480,6 +628,7 @@ export async function syncVodSeries(source: Source): Promise<{ count: number; ca
     if (toRemove.length > 0) {
       // Delete orphaned episodes first (they reference series_id)
       await db.vodEpisodes.where('series_id').anyOf(toRemove).delete();
+      await db.seriesEpisodeFetches.bulkDelete(toRemove);
       await db.vodSeries.bulkDelete(toRemove);
       console.log(`[VOD Series] Removed ${toRemove.length} series (and their episodes) no longer in source`);
     }
@@ -488,17 +637,14 @@ export async function syncVodSeries(source: Source): Promise<{ count: number; ca
   return { count: storedSeries.length, categoryCount: vodCategories.length };
 }
 
-// Sync episodes for a specific series (on-demand when user views series details)
+// Sync episodes for a specific series (on-demand when user views series details,
+// or ahead of time from the episode prefetch queue)
 export async function syncSeriesEpisodes(source: Source, seriesId: string): Promise<number> {
-  if (source.type !== 'xtream' || !source.username || !source.password) {
+  const client = getXtreamClient(source);
+  if (!client) {
     return 0;
   }
 
-  const client = new XtreamClient(
-    { baseUrl: source.url, username: source.username, password: source.password },
-    source.id
-  );
-
   const seasons = await client.getSeriesInfo(seriesId);
 
   // Flatten episodes from all seasons
@@ -513,13 +659,15 @@ export async function syncSeriesEpisodes(source: Source, seriesId: string): Prom
   }
 
   // Store episodes
-  await db.transaction('rw', [db.vodEpisodes], async () => {
+  await db.transaction('rw', [db.vodEpisodes, db.seriesEpisodeFetches], async () => {
     // Clear existing episodes for this series
     await db.vodEpisodes.where('series_id').equals(seriesId).delete();
 
     if (storedEpisodes.length > 0) {
       await db.vodEpisodes.bulkPut(storedEpisodes);
     }
+    const now = Date.now();
+    await db.seriesEpisodeFetches.put({ series_id: seriesId, source_id: source.id, fetched_at: now, last_used: now });
   });
 
   return storedEpisodes.length;
@@ -713,6 +861,9 @@ export async function syncVodForSource(source: Source): Promise<VodSyncResult> {
       });
     }
 
+    // TMDB matching below writes again and emits the final change
+    emitChange(source.id, 'vod', true);
+
     // Match against TMDB exports (runs in background, no API calls)
     // This enriches movies/series with tmdb_id for the curated lists
     // Uses reference counting to handle concurrent syncs correctly
@@ -724,6 +875,8 @@ export async function syncVodForSource(source: Source): Promise<VodSyncResult> {
       .catch(console.error)
       .finally(() => {
         endTmdbMatching();
+        // Matches add tmdb_id / popularity to the rows
+        emitChange(source.id, 'vod');
       });
 
     return {
@@ -746,23 +899,28 @@ export async function syncVodForSource(source: Source): Promise<VodSyncResult> {
   }
 }
 
-// Sync VOD for all Xtream sources
-export async function syncAllVod(): Promise<Map<string, VodSyncResult>> {
+// Sync VOD for all Xtream sources (or only those in `sources`)
+export async function syncAllVod(sources?: Source[]): Promise<Map<string, VodSyncResult>> {
   const results = new Map<string, VodSyncResult>();
 
-  if (!window.storage) {
-    console.error('Storage API not available');
-    return results;
-  }
+  if (!sources) {
+    if (!window.storage) {
+      console.error('Storage API not available');
+      return results;
+    }
 
-  const sourcesResult = await window.storage.getSources();
-  if (!sourcesResult.data) {
-    console.error('Failed to get sources:', sourcesResult.error);
-    return results;
+    const sourcesResult = await window.storage.getSources();
+    if (!sourcesResult.data) {
+      console.error('Failed to get sources:', sourcesResult.error);
+      return results;
+    }
+    sources = sourcesResult.data;
   }
 
   // Sync VOD for each enabled Xtream source
-  for (const source of sourcesResult.data) {
+  const generation = syncGeneration;
+  for (const source of sources) {
+    if (syncGeneration !== generation) break;
     if (source.enabled && source.type === 'xtream') {
       console.log(`Syncing VOD for source: ${source.name}`);
       const result = await syncVodForSource(source);
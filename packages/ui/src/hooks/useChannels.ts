@@ -1,7 +1,11 @@
 import { useLiveQuery } from 'dexie-react-hooks';
 import { db, getLastCategory, setLastCategory } from '../db';
-import type { StoredChannel, StoredCategory, SourceMeta, StoredProgram } from '../db';
-import { useState, useEffect, useCallback } from 'react';
+import type { StoredChannel, StoredCategory, SourceMeta, ProgramSummary } from '../db';
+import { blockKey, dayOf, programAt, unpackProgramBlock } from '../db/program-blocks';
+import { getCachedDescription, loadProgramDescription } from '../db/description-cache';
+import { getSearchIndexVersion, searchPrograms, subscribeSearchIndex, warmSearchIndex, type EpgSearchHit } from '../db/epg-search';
+import { useCatalogQuery, querySqliteCatalog } from '../db/catalog-backend';
+import { useState, useEffect, useCallback, useSyncExternalStore } from 'react';
 
 // Hook to get all categories across all sources
 export function useCategories() {
@@ -78,9 +82,11 @@ export function useSelectedCategory() {
 }
 
 // Hook to search channels by name
+// (with the SQLite catalog backend, words match name word prefixes via FTS5)
 export function useChannelSearch(query: string, limit = 50) {
-  const channels = useLiveQuery(
-    () => {
+  const channels = useCatalogQuery(
+    'channel search',
+    async () => {
       if (!query || query.length < 2) {
         return [];
       }
@@ -90,11 +96,29 @@ export function useChannelSearch(query: string, limit = 50) {
         .limit(limit)
         .toArray();
     },
+    async () => {
+      if (!query || query.length < 2) {
+        return [];
+      }
+      return (await querySqliteCatalog<StoredChannel>({ kind: 'channel', search: query, limit })).items;
+    },
     [query, limit]
   );
   return channels ?? [];
 }
 
+// Hook to search upcoming programmes by title/description words (see db/epg-search.ts)
+// Searches run against an in-memory index, so they re-run when its version changes
+export function useProgramSearch(query: string, limit = 50): EpgSearchHit[] {
+  const version = useSyncExternalStore(subscribeSearchIndex, getSearchIndexVersion);
+  useEffect(warmSearchIndex, []);
+  const hits = useLiveQuery(
+    () => (query.trim().length < 2 ? [] : searchPrograms(query, limit)),
+    [query, limit, version]
+  );
+  return hits ?? [];
+}
+
 // Categories with channel counts
 export interface CategoryWithCount extends StoredCategory {
   channelCount: number;
@@ -115,19 +139,29 @@ export function useCategoriesWithCounts(): CategoryWithCount[] {
   return data ?? [];
 }
 
+// Latest programme on a channel that started at or before `now` and is still running.
+// Reads the channel's blocks for today and yesterday (a show may run past midnight)
+async function findCurrentProgram(streamId: string, now: Date): Promise<ProgramSummary | null> {
+  const nowMs = now.getTime();
+  const today = dayOf(nowMs);
+  const blocks = await db.programBlocks.bulkGet([blockKey(streamId, today), blockKey(streamId, today - 1)]);
+  for (const block of blocks) {
+    if (!block) continue;
+    for (let i = block.starts.length - 1; i >= 0; i--) {
+      const program = programAt(block, i);
+      if (program.start.getTime() > nowMs) continue;
+      return program.end.getTime() > nowMs ? program : null;
+    }
+  }
+  return null;
+}
+
 // Hook to get current program for a channel
-export function useCurrentProgram(streamId: string | null): StoredProgram | null {
+export function useCurrentProgram(streamId: string | null): ProgramSummary | null {
   const program = useLiveQuery(
     async () => {
       if (!streamId) return null;
-      const now = new Date();
-      // Find program where start <= now < end
-      const programs = await db.programs
-        .where('stream_id')
-        .equals(streamId)
-        .filter((p) => p.start <= now && p.end > now)
-        .first();
-      return programs ?? null;
+      return findCurrentProgram(streamId, new Date());
     },
     [streamId]
   );
@@ -135,48 +169,40 @@ export function useCurrentProgram(streamId: string | null): StoredProgram | null
 }
 
 // Hook to get all programs for channels within a time range (for EPG grid)
+// Reads packed per-channel-day blocks: one bulkGet of channels x days records
 export function useProgramsInRange(
   streamIds: string[],
   windowStart: Date,
   windowEnd: Date
-): Map<string, StoredProgram[]> {
+): Map<string, ProgramSummary[]> {
   const programs = useLiveQuery(
     async () => {
-      if (streamIds.length === 0) return new Map<string, StoredProgram[]>();
-
-      const result = new Map<string, StoredProgram[]>();
+      if (streamIds.length === 0) return new Map<string, ProgramSummary[]>();
+
+      const fromMs = windowStart.getTime();
+      const toMs = windowEnd.getTime();
+
+      // Programmes are filed under their start day, so include the day before
+      // the window for shows that run past midnight
+      const firstDay = dayOf(fromMs) - 1;
+      const lastDay = dayOf(toMs - 1);
+      const keys: string[] = [];
+      for (const id of new Set(streamIds)) {
+        for (let day = firstDay; day <= lastDay; day++) {
+          keys.push(blockKey(id, day));
+        }
+      }
+      const blocks = await db.programBlocks.bulkGet(keys);
 
-      // Initialize empty arrays for all channels
+      // Blocks come back in key order (channel, then ascending day), so each
+      // channel's programmes are already sorted by start time
+      const result = new Map<string, ProgramSummary[]>();
       for (const id of streamIds) {
         result.set(id, []);
       }
-
-      // Fetch all programs that overlap with the time window
-      // A program overlaps if: program.start < windowEnd AND program.end > windowStart
-      const allPrograms = await db.programs
-        .where('stream_id')
-        .anyOf(streamIds)
-        .filter((p) => {
-          const start = p.start instanceof Date ? p.start : new Date(p.start);
-          const end = p.end instanceof Date ? p.end : new Date(p.end);
-          return start < windowEnd && end > windowStart;
-        })
-        .toArray();
-
-      // Group by stream_id and sort by start time
-      for (const prog of allPrograms) {
-        const existing = result.get(prog.stream_id) ?? [];
-        existing.push(prog);
-        result.set(prog.stream_id, existing);
-      }
-
-      // Sort each channel's programs by start time
-      for (const [, progs] of result) {
-        progs.sort((a, b) => {
-          const aStart = a.start instanceof Date ? a.start.getTime() : new Date(a.start).getTime();
-          const bStart = b.start instanceof Date ? b.start.getTime() : new Date(b.start).getTime();
-          return aStart - bStart;
-        });
+      for (const block of blocks) {
+        if (!block) continue;
+        result.get(block.stream_id)?.push(...unpackProgramBlock(block, fromMs, toMs));
       }
 
       return result;
@@ -187,25 +213,38 @@ export function useProgramsInRange(
   return programs ?? new Map();
 }
 
+// Hook to lazily load a programme's description (pass null to skip loading)
+// Backed by an LRU cache, see db/description-cache.ts
+export function useProgramDescription(programId: string | null): string | null {
+  const [loaded, setLoaded] = useState<{ id: string; description: string | null } | null>(null);
+  const cached = programId ? getCachedDescription(programId) : undefined;
+
+  useEffect(() => {
+    if (!programId || cached !== undefined) return;
+    let cancelled = false;
+    loadProgramDescription(programId).then((description) => {
+      if (!cancelled) setLoaded({ id: programId, description });
+    });
+    return () => {
+      cancelled = true;
+    };
+  }, [programId, cached]);
+
+  if (!programId) return null;
+  if (cached !== undefined) return cached;
+  return loaded?.id === programId ? loaded.description : null;
+}
+
 // Hook to get programs for a list of channel IDs (queries local DB - EPG is synced upfront)
-export function usePrograms(streamIds: string[]): Map<string, StoredProgram | null> {
+export function usePrograms(streamIds: string[]): Map<string, ProgramSummary | null> {
   const programs = useLiveQuery(
     async () => {
       if (streamIds.length === 0) return new Map();
       const now = new Date();
-      const result = new Map<string, StoredProgram | null>();
+      const result = new Map<string, ProgramSummary | null>();
 
       for (const id of streamIds) {
-        const program = await db.programs
-          .where('stream_id')
-          .equals(id)
-          .filter((p) => {
-            const start = p.start instanceof Date ? p.start : new Date(p.start);
-            const end = p.end instanceof Date ? p.end : new Date(p.end);
-            return start <= now && end > now;
-          })
-          .first();
-        result.set(id, program ?? null);
+        result.set(id, await findCurrentProgram(id, now));
       }
       return result;
     },
@@ -1,8 +1,124 @@
-import { useState, useEffect, useCallback } from 'react';
+import { useState, useEffect, useCallback, useRef } from 'react';
 import { useLiveQuery } from 'dexie-react-hooks';
+import type { Table } from 'dexie';
 import { db, type StoredMovie, type StoredSeries, type StoredEpisode, type VodCategory } from '../db';
-import { syncSeriesEpisodes, syncAllVod, type VodSyncResult } from '../db/sync';
-import type { Source } from '../types/electron';
+import { useCatalogBackend, useCatalogVersion, useCatalogQuery, timedCatalogQuery, querySqliteCatalog } from '../db/catalog-backend';
+import { syncSeriesEpisodes, type VodSyncResult } from '../db/sync';
+import { requestVodSync } from '../db/sync-client';
+import { touchSeriesEpisodes } from '../db/episode-prefetch';
+import type { Source, CatalogCursor } from '../types/electron';
+
+// Rows per page when browsing the SQLite catalog
+const CATALOG_PAGE_SIZE = 300;
+
+// ===========================================================================
+// Catalog backend helpers
+// ===========================================================================
+
+/**
+ * Browse list for the gallery view. IndexedDB loads every matching row and
+ * sorts in memory; SQLite loads pages in name order as the grid scrolls.
+ */
+function useBrowseQuery<T extends { name: string }>(
+  kind: 'movie' | 'series',
+  table: Table<T, string>,
+  categoryId: string | null,
+  search?: string
+) {
+  const backend = useCatalogBackend();
+  // SQLite lists reload after the catalog is written (a sync was mirrored)
+  const version = useCatalogVersion();
+  const [items, setItems] = useState<T[]>([]);
+  const [loading, setLoading] = useState(false);
+  const [next, setNext] = useState<CatalogCursor | undefined>(undefined);
+  // Identifies the current query so late pages of an old one are dropped
+  const queryRef = useRef(0);
+  // List shown and rows loaded, so a reload after a catalog write keeps the
+  // pages already scrolled through
+  const listRef = useRef({ key: '', loaded: 0 });
+
+  useEffect(() => {
+    if (!backend) return;
+    const queryId = ++queryRef.current;
+    const listKey = `${backend}|${kind}|${categoryId ?? ''}|${search ?? ''}`;
+    const reloadCount = listRef.current.key === listKey ? listRef.current.loaded : 0;
+    const label = `${kind} browse${categoryId ? ' (category)' : ''}${search ? ' (search)' : ''}`;
+
+    const fetchFirst = async () => {
+      setLoading(true);
+      try {
+        if (backend === 'sqlite') {
+          const page = await timedCatalogQuery(label, backend, () =>
+            querySqliteCatalog<T>({
+              kind, categoryId: categoryId ?? undefined, search, limit: Math.max(CATALOG_PAGE_SIZE, reloadCount),
+            })
+          );
+          if (queryId !== queryRef.current) return;
+          listRef.current = { key: listKey, loaded: page.items.length };
+          setItems(page.items);
+          setNext(page.next);
+          return;
+        }
+
+        const result = await timedCatalogQuery(label, backend, async () => {
+          let rows: T[];
+          if (categoryId) {
+            // Filter by category
+            rows = await table.where('category_ids').equals(categoryId).toArray();
+          } else {
+            // All rows
+            rows = await table.toArray();
+          }
+
+          // Apply search filter
+          if (search) {
+            const searchLower = search.toLowerCase();
+            rows = rows.filter(r => r.name.toLowerCase().includes(searchLower));
+          }
+
+          // Sort alphabetically
+          return rows.sort((a, b) => a.name.localeCompare(b.name));
+        });
+        if (queryId !== queryRef.current) return;
+        listRef.current = { key: listKey, loaded: result.length };
+        setItems(result);
+        setNext(undefined);
+      } catch (err) {
+        console.error('[Catalog] Browse query failed:', err);
+      } finally {
+        if (queryId === queryRef.current) setLoading(false);
+      }
+    };
+
+    fetchFirst();
+  }, [backend, version, kind, table, categoryId, search]);
+
+  const loadMore = useCallback(async () => {
+    if (backend !== 'sqlite' || !next) return;
+    const queryId = queryRef.current;
+    setLoading(true);
+    try {
+      const page = await timedCatalogQuery(`${kind} browse (next page)`, backend, () =>
+        querySqliteCatalog<T>({ kind, categoryId: categoryId ?? undefined, search, limit: CATALOG_PAGE_SIZE, after: next })
+      );
+      if (queryId !== queryRef.current) return;
+      listRef.current.loaded += page.items.length;
+      setItems((prev) => [...prev, ...page.items]);
+      setNext(page.next);
+    } catch (err) {
+      console.error('[Catalog] Browse query failed:', err);
+    } finally {
+      if (queryId === queryRef.current) setLoading(false);
+    }
+  }, [backend, next, kind, categoryId, search]);
+
+  return {
+    items,
+    loading,
+    hasMore: !!next,
+    loadMore,
+  };
+}
 
 // ===========================================================================
 // Movies Hooks
@@ -64,13 +180,12 @@ export function useMovie(movieId: string | null) {
  * Get recently added movies
  */
 export function useRecentMovies(limit = 20) {
-  const movies = useLiveQuery(async () => {
-    return db.vodMovies
-      .orderBy('added')
-      .reverse()
-      .limit(limit)
-      .toArray();
-  }, [limit]);
+  const movies = useCatalogQuery(
+    'recent movies',
+    () => db.vodMovies.orderBy('added').reverse().limit(limit).toArray(),
+    async () => (await querySqliteCatalog<StoredMovie>({ kind: 'movie', order: 'added', limit })).items,
+    [limit]
+  );
 
   return {
     movies: movies ?? [],
@@ -138,13 +253,12 @@ export function useSeriesById(seriesId: string | null) {
  * Get recently added series
  */
 export function useRecentSeries(limit = 20) {
-  const series = useLiveQuery(async () => {
-    return db.vodSeries
-      .orderBy('added')
-      .reverse()
-      .limit(limit)
-      .toArray();
-  }, [limit]);
+  const series = useCatalogQuery(
+    'recent series',
+    () => db.vodSeries.orderBy('added').reverse().limit(limit).toArray(),
+    async () => (await querySqliteCatalog<StoredSeries>({ kind: 'series', order: 'added', limit })).items,
+    [limit]
+  );
 
   return {
     series: series ?? [],
@@ -204,6 +318,11 @@ export function useSeriesDetails(seriesId: string | null) {
     }
   }, [seriesId]);
 
+  // Opening a series keeps its cached episodes out of LRU eviction
+  useEffect(() => {
+    if (seriesId) touchSeriesEpisodes(seriesId);
+  }, [seriesId]);
+
   // Fetch on mount if no episodes cached
   useEffect(() => {
     if (episodes && episodes.length === 0 && seriesId) {
@@ -243,20 +362,32 @@ export function useSeriesDetails(seriesId: string | null) {
  * Get VOD categories by type (excludes empty categories)
  */
 export function useVodCategories(type: 'movie' | 'series') {
-  const categories = useLiveQuery(async () => {
-    const allCategories = await db.vodCategories.where('type').equals(type).toArray();
-
-    // Filter out categories with no items
-    const nonEmptyCategories = await Promise.all(
-      allCategories.map(async (cat) => {
-        const table = type === 'movie' ? db.vodMovies : db.vodSeries;
-        const count = await table.where('category_ids').equals(cat.category_id).count();
-        return count > 0 ? cat : null;
-      })
-    );
-
-    return nonEmptyCategories.filter((cat): cat is VodCategory => cat !== null);
-  }, [type]);
+  const categories = useCatalogQuery(
+    `${type} categories`,
+    async () => {
+      const allCategories = await db.vodCategories.where('type').equals(type).toArray();
+
+      // Filter out categories with no items
+      const nonEmptyCategories = await Promise.all(
+        allCategories.map(async (cat) => {
+          const table = type === 'movie' ? db.vodMovies : db.vodSeries;
+          const count = await table.where('category_ids').equals(cat.category_id).count();
+          return count > 0 ? cat : null;
+        })
+      );
+
+      return nonEmptyCategories.filter((cat): cat is VodCategory => cat !== null);
+    },
+    async () => {
+      const [allCategories, result] = await Promise.all([
+        db.vodCategories.where('type').equals(type).toArray(),
+        window.catalog!.categories(type),
+      ]);
+      const nonEmpty = new Set(result.data ?? []);
+      return allCategories.filter((cat) => nonEmpty.has(cat.category_id));
+    },
+    [type]
+  );
 
   return {
     categories: categories ?? [],
@@ -295,7 +426,7 @@ export function useVodSync() {
     setError(null);
 
     try {
-      const syncResults = await syncAllVod();
+      const syncResults = await requestVodSync();
       setResults(syncResults);
     } catch (err) {
       setError(err instanceof Error ? err.message : 'Sync failed');
@@ -320,13 +451,21 @@ export function useVodSync() {
  * Get total counts of movies and series
  */
 export function useVodCounts() {
-  const counts = useLiveQuery(async () => {
-    const [movieCount, seriesCount] = await Promise.all([
-      db.vodMovies.count(),
-      db.vodSeries.count(),
-    ]);
-    return { movieCount, seriesCount };
-  });
+  const counts = useCatalogQuery(
+    'vod counts',
+    async () => {
+      const [movieCount, seriesCount] = await Promise.all([
+        db.vodMovies.count(),
+        db.vodSeries.count(),
+      ]);
+      return { movieCount, seriesCount };
+    },
+    async () => {
+      const result = await window.catalog!.getStats();
+      return { movieCount: result.data?.movies ?? 0, seriesCount: result.data?.series ?? 0 };
+    },
+    []
+  );
 
   return {
     movieCount: counts?.movieCount ?? 0,
@@ -343,100 +482,20 @@ export function useVodCounts() {
  * All movies for browse view (optionally filtered by category)
  * Returns items sorted alphabetically - Virtuoso handles virtualization
  * Pass null for categoryId to get ALL movies
+ * With the SQLite backend items arrive a page at a time (hasMore / loadMore)
  */
 export function usePaginatedMovies(categoryId: string | null, search?: string) {
-  const [items, setItems] = useState<StoredMovie[]>([]);
-  const [loading, setLoading] = useState(false);
-
-  useEffect(() => {
-    const fetchAll = async () => {
-      setLoading(true);
-      try {
-        let result: StoredMovie[];
-
-        if (categoryId) {
-          // Filter by category
-          result = await db.vodMovies.where('category_ids').equals(categoryId).toArray();
-        } else {
-          // All movies
-          result = await db.vodMovies.toArray();
-        }
-
-        // Apply search filter
-        if (search) {
-          const searchLower = search.toLowerCase();
-          result = result.filter(m => m.name.toLowerCase().includes(searchLower));
-        }
-
-        // Sort alphabetically
-        result.sort((a, b) => a.name.localeCompare(b.name));
-
-        setItems(result);
-      } finally {
-        setLoading(false);
-      }
-    };
-
-    fetchAll();
-  }, [categoryId, search]);
-
-  // Keep API compatible - Virtuoso handles virtualization, no pagination needed
-  return {
-    items,
-    loading,
-    hasMore: false,
-    loadMore: () => {},
-  };
+  return useBrowseQuery<StoredMovie>('movie', db.vodMovies, categoryId, search);
 }
 
 /**
  * All series for browse view (optionally filtered by category)
  * Returns items sorted alphabetically - Virtuoso handles virtualization
  * Pass null for categoryId to get ALL series
+ * With the SQLite backend items arrive a page at a time (hasMore / loadMore)
  */
 export function usePaginatedSeries(categoryId: string | null, search?: string) {
-  const [items, setItems] = useState<StoredSeries[]>([]);
-  const [loading, setLoading] = useState(false);
-
-  useEffect(() => {
-    const fetchAll = async () => {
-      setLoading(true);
-      try {
-        let result: StoredSeries[];
-
-        if (categoryId) {
-          // Filter by category
-          result = await db.vodSeries.where('category_ids').equals(categoryId).toArray();
-        } else {
-          // All series
-          result = await db.vodSeries.toArray();
-        }
-
-        // Apply search filter
-        if (search) {
-          const searchLower = search.toLowerCase();
-          result = result.filter(s => s.name.toLowerCase().includes(searchLower));
-        }
-
-        // Sort alphabetically
-        result.sort((a, b) => a.name.localeCompare(b.name));
-
-        setItems(result);
-      } finally {
-        setLoading(false);
-      }
-    };
-
-    fetchAll();
-  }, [categoryId, search]);
-
-  // Keep API compatible - Virtuoso handles virtualization, no pagination needed
-  return {
-    items,
-    loading,
-    hasMore: false,
-    loadMore: () => {},
-  };
+  return useBrowseQuery<StoredSeries>('series', db.vodSeries, categoryId, search);
 }
 
 /**
@@ -11,6 +11,8 @@
  * Also supports enriched exports with year data from GitHub cache.
  */
 
+import { fetchByteStream, fetchTextChunks } from '@sbtltv/local-adapter';
+
 // ===========================================================================
 // Types
 // ===========================================================================
@@ -130,7 +132,7 @@ export function extractMatchParams(item: { name: string; title?: string; year?:
 
 /**
  * Download and parse enriched TMDB data from GitHub cache (NDJSON format)
- * Uses streaming to avoid blocking main thread with 1M+ entries
+ * Parsed line by line as the download streams in
  * Returns null if unavailable (will fall back to regular exports)
  */
 async function downloadEnrichedExport(type: 'movie' | 'tv'): Promise<TmdbExportData | null> {
@@ -138,39 +140,16 @@ async function downloadEnrichedExport(type: 'movie' | 'tv'): Promise<TmdbExportD
   console.log(`[TMDB Export] Downloading enriched ${type} data from GitHub...`);
 
   try {
-    let textContent: string;
-
-    // Use Electron's fetch proxy if available (bypasses CORS)
-    if (typeof window !== 'undefined' && window.fetchProxy?.fetch) {
-      const result = await window.fetchProxy.fetch(url);
-      if (!result.success || !result.data || !result.data.ok) {
-        console.warn(`[TMDB Export] Enriched ${type} fetch failed:`, result.error || result.data?.statusText);
-        return null;
-      }
-      textContent = result.data.text;
-    } else {
-      const response = await fetch(url);
-      if (!response.ok) {
-        console.warn(`[TMDB Export] Enriched ${type} not available: ${response.status}`);
-        return null;
-      }
-      textContent = await response.text();
-    }
-
-    // Parse NDJSON (one entry per line) - much faster than single JSON.parse
-    const lines = textContent.split('\n');
-    console.log(`[TMDB Export] Parsing ${lines.length} enriched ${type} entries...`);
-
     // Build lookup maps
     const entries = new Map<string, TmdbExportEntry[]>();
     const byId = new Map<number, TmdbExportEntry>();
 
-    for (const line of lines) {
-      if (!line.trim()) continue;
+    const addLine = (line: string) => {
+      if (!line.trim()) return;
 
       const e = JSON.parse(line) as EnrichedEntry;
       const normalized = normalizeTitle(e.t);
-      if (!normalized) continue;
+      if (!normalized) return;
 
       const entry: TmdbExportEntry = {
         id: e.i,
@@ -187,7 +166,18 @@ async function downloadEnrichedExport(type: 'movie' | 'tv'): Promise<TmdbExportD
 
       // Add to ID index
       byId.set(e.i, entry);
+    };
+
+    // Parse NDJSON (one entry per line) while it downloads - the full text
+    // is never held as one string (streamed through the fetch proxy when available)
+    let buffer = '';
+    for await (const chunk of fetchTextChunks(url, `enriched ${type} data`)) {
+      buffer += chunk;
+      const lines = buffer.split('\n');
+      buffer = lines.pop() || '';
+      for (const line of lines) addLine(line);
     }
+    addLine(buffer);
 
     console.log(`[TMDB Export] Indexed ${entries.size} unique enriched ${type} titles`);
 
@@ -235,36 +225,16 @@ async function downloadExport(type: 'movie' | 'tv'): Promise<TmdbExportData> {
   const url = buildExportUrl(type);
   console.log(`[TMDB Export] Downloading ${type} export from ${url}`);
 
-  let gzippedData: ArrayBuffer;
-
-  // Use Electron's binary fetch proxy (bypasses CORS, returns base64)
-  if (typeof window !== 'undefined' && window.fetchProxy?.fetchBinary) {
-    const result = await window.fetchProxy.fetchBinary(url);
-    if (!result.success || !result.data) {
-      throw new Error(result.error || 'Failed to fetch TMDB export');
-    }
-    // Decode base64 to ArrayBuffer
-    const binaryString = atob(result.data);
-    const bytes = new Uint8Array(binaryString.length);
-    for (let i = 0; i < binaryString.length; i++) {
-      bytes[i] = binaryString.charCodeAt(i);
-    }
-    gzippedData = bytes.buffer;
-  } else {
-    // Fallback to regular fetch (works in Node.js or when CORS is not an issue)
-    const response = await fetch(url);
-    if (!response.ok) {
-      throw new Error(`Failed to download TMDB export: ${response.status}`);
-    }
-    gzippedData = await response.arrayBuffer();
-  }
+  // Streamed through Electron's fetch proxy when available (bypasses CORS),
+  // so decompression and parsing start with the first bytes
+  const gzippedStream = await fetchByteStream(url, 'TMDB export');
 
   // Decompress and parse using streaming (avoids ~200MB memory spike)
   const entries = new Map<string, TmdbExportEntry[]>();
   const byId = new Map<number, TmdbExportEntry>();
 
   // Create streaming pipeline: gzip → text decoder
-  const decompressedStream = new Response(gzippedData).body!
+  const decompressedStream = gzippedStream
     .pipeThrough(new DecompressionStream('gzip'))
     .pipeThrough(new TextDecoderStream());
 
@@ -6,6 +6,8 @@
  */
 
 import { create } from 'zustand';
+import type { EpgProgress } from '../db/epg-ingest';
+import type { CatalogProgress } from '../db/catalog-sync';
 
 interface UIState {
   // Movies page
@@ -23,6 +25,14 @@ interface UIState {
   setChannelSyncing: (value: boolean) => void;
   setVodSyncing: (value: boolean) => void;
   setTmdbMatching: (value: boolean) => void;
+
+  // EPG worker progress (null when no guide is loading)
+  epgProgress: EpgProgress | null;
+  setEpgProgress: (progress: EpgProgress | null) => void;
+
+  // Per-category catalog fetches in progress, keyed by `${sourceId}:${kind}`
+  catalogProgress: Record<string, CatalogProgress>;
+  setCatalogProgress: (key: string, progress: CatalogProgress | null) => void;
 }
 
 export const useUIStore = create<UIState>((set) => ({
@@ -41,6 +51,19 @@ export const useUIStore = create<UIState>((set) => ({
   setChannelSyncing: (value) => set({ channelSyncing: value }),
   setVodSyncing: (value) => set({ vodSyncing: value }),
   setTmdbMatching: (value) => set({ tmdbMatching: value }),
+
+  // EPG progress
+  epgProgress: null,
+  setEpgProgress: (progress) => set({ epgProgress: progress }),
+
+  // Catalog progress
+  catalogProgress: {},
+  setCatalogProgress: (key, progress) => set((state) => {
+    const catalogProgress = { ...state.catalogProgress };
+    if (progress) catalogProgress[key] = progress;
+    else delete catalogProgress[key];
+    return { catalogProgress };
+  }),
 }));
 
 // Selectors for cleaner component code
@@ -57,3 +80,5 @@ export const useVodSyncing = () => useUIStore((s) => s.vodSyncing);
 export const useSetVodSyncing = () => useUIStore((s) => s.setVodSyncing);
 export const useTmdbMatching = () => useUIStore((s) => s.tmdbMatching);
 export const useSetTmdbMatching = () => useUIStore((s) => s.setTmdbMatching);
+export const useEpgProgress = () => useUIStore((s) => s.epgProgress);
+export const useCatalogProgress = () => useUIStore((s) => s.catalogProgress);
@@ -49,11 +49,14 @@ export interface AppSettings {
   tmdbApiKey?: string;
   vodRefreshHours?: number;  // 0 = manual only, default 24
   epgRefreshHours?: number;  // 0 = manual only, default 6
+  epgRetentionPastHours?: number;   // EPG history kept, default 24
+  epgRetentionFutureDays?: number;  // EPG look-ahead kept (0 = all), default 3
   movieGenresEnabled?: number[];   // TMDB genre IDs to show as carousels
   seriesGenresEnabled?: number[];  // TMDB genre IDs for TV shows
   posterDbApiKey?: string;         // RatingPosterDB API key for rating posters
   rpdbBackdropsEnabled?: boolean;  // Use RPDB backdrops (requires tier 2+ key)
   allowLanSources?: boolean;       // Allow requests to LAN IPs (SSRF bypass)
+  catalogBackend?: 'indexeddb' | 'sqlite';  // Where movie/series/channel browsing queries run
 }
 
 export interface Source {
@@ -64,15 +67,32 @@ export interface Source {
   enabled: boolean;
   epg_url?: string;
   auto_load_epg?: boolean;
+  epg_mode?: 'full' | 'on_demand';
+  fetch_by_category?: boolean; // Xtream only: fetch catalogs per category in parallel
   username?: string;
   password?: string;
 }
 
 export interface M3UImportResult {
-  content: string;
+  importId: string;   // Pass to streamM3UImport to receive the file contents
   fileName: string;
+  size: number;       // Bytes
 }
 
+// Messages on the MessagePort delivered for streamM3UImport
+// (main → renderer; the renderer answers each chunk with { type: 'ack' })
+export type M3UFileStreamMessage =
+  | { type: 'chunk'; data: Uint8Array }
+  | { type: 'end' }
+  | { type: 'error'; error: string };
+
+// Messages on a fetchJsonArray port: the array's elements in batches, parsed
+// while downloading (acknowledged and cancelled like a fetchStream port)
+export type FetchJsonArrayMessage =
+  | { type: 'items'; items: unknown[] }
+  | { type: 'end' }
+  | { type: 'error'; error: string };
+
 export interface StorageApi {
   getSources: () => Promise<StorageResult<Source[]>>;
   getSource: (id: string) => Promise<StorageResult<Source | undefined>>;
@@ -82,18 +102,134 @@ export interface StorageApi {
   updateSettings: (settings: Partial<AppSettings>) => Promise<StorageResult>;
   isEncryptionAvailable: () => Promise<StorageResult<boolean>>;
   importM3UFile: () => Promise<StorageResult<M3UImportResult> & { canceled?: boolean }>;
+  // Starts streaming an imported file. The port arrives as a window message
+  // { type: 'm3u-import-port', importId } with the port in event.ports.
+  streamM3UImport: (importId: string) => Promise<StorageResult>;
 }
 
 export interface FetchProxyResponse {
   ok: boolean;
   status: number;
   statusText: string;
-  text: string;
+  text: string;        // Empty when responseType is 'arraybuffer'
+  body?: Uint8Array;   // Raw (undecoded) body when responseType is 'arraybuffer'
+  headers?: Record<string, string>;  // Response headers (lower-case names)
+}
+
+// fetchJsonArray response: the status; the elements follow over a MessagePort
+export interface FetchJsonArrayResponse {
+  ok: boolean;
+  status: number;
+  statusText: string;
+}
+
+// Per-host request statistics from the main-process fetch scheduler
+export interface FetchHostStats {
+  host: string;
+  requests: number;       // Completed requests (after retries)
+  failures: number;       // Requests that failed for good
+  retries: number;
+  timeouts: number;
+  active: number;
+  queued: number;
+  avgLatencyMs: number;   // Time to response headers
+  maxLatencyMs: number;
+  coalescedHits: number;   // Requests that shared another caller's in-flight request
+  coalescedMisses: number; // Coalescable requests that went to the network
+  lastStatus?: number;
+  lastError?: string;
+}
+
+// fetchStream response: status and headers; the body follows over a MessagePort
+export interface FetchStreamResponse {
+  ok: boolean;
+  status: number;
+  statusText: string;
+  headers: Record<string, string>;  // Response headers (lower-case names)
+}
+
+// Messages on a fetchStream port (main → renderer). The renderer answers
+// each chunk with { type: 'ack' } and can stop the download with { type: 'cancel' }.
+export type FetchStreamMessage =
+  | { type: 'chunk'; data: Uint8Array }
+  | { type: 'end' }
+  | { type: 'error'; error: string };
+
+// Disk HTTP cache counters since startup, plus current size
+export interface HttpCacheStats {
+  hits: number;         // Served from disk without a request
+  revalidated: number;  // 304 - served from disk after a conditional request
+  misses: number;       // Body downloaded
+  bytesFromCache: number;
+  entries: number;
+  size: number;         // Bytes on disk
+}
+
+export interface FetchProxyOptions {
+  method?: string;
+  headers?: Record<string, string>;
+  body?: string;
+  responseType?: 'text' | 'arraybuffer';
 }
 
 export interface FetchProxyApi {
-  fetch: (url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) => Promise<StorageResult<FetchProxyResponse>>;
-  fetchBinary: (url: string) => Promise<StorageResult<string>>; // Returns base64-encoded data
+  fetch: (url: string, options?: FetchProxyOptions) => Promise<StorageResult<FetchProxyResponse>>;
+  // Same port relay as fetchStream; no elements arrive when !ok
+  fetchJsonArray: (streamId: string, url: string) => Promise<StorageResult<FetchJsonArrayResponse>>;
+  // Streaming fetch. Resolves once headers arrive; the body is sent over a
+  // MessagePort relayed as a window message { type: 'fetch-stream-port', streamId }.
+  fetchStream: (streamId: string, url: string, options?: FetchProxyOptions) => Promise<StorageResult<FetchStreamResponse>>;
+  getStats: () => Promise<StorageResult<FetchHostStats[]>>;
+  getCacheStats: () => Promise<StorageResult<HttpCacheStats>>;
+}
+
+// SQLite catalog backend (selected with the catalogBackend setting)
+export type CatalogKind = 'movie' | 'series' | 'channel';
+
+export interface CatalogCursor {
+  key: string | number;  // name or added of the last row
+  rowid: number;
+}
+
+export interface CatalogQuery {
+  kind: CatalogKind;
+  categoryId?: string;
+  search?: string;              // Every word must prefix-match a word of the name
+  order?: 'name' | 'added';     // name ascending (default) or newest first
+  limit: number;
+  after?: CatalogCursor;        // Continue after the last row of the previous page
+}
+
+export interface CatalogPage<T = unknown> {
+  items: T[];
+  next?: CatalogCursor;  // Undefined on the last page
+}
+
+export interface CatalogStats {
+  movies: number;
+  series: number;
+  channels: number;
+  size: number;  // Database file size in bytes
+}
+
+export interface CatalogApi {
+  query: (query: CatalogQuery) => Promise<StorageResult<CatalogPage>>;
+  // Category ids of a kind with at least one item
+  categories: (kind: CatalogKind) => Promise<StorageResult<string[]>>;
+  // Mirror a source's rows: write() batches tagged with syncId, then finish()
+  // drops the source's rows of that kind not written by the sync
+  write: (kind: CatalogKind, sourceId: string, syncId: number, rows: unknown[]) => Promise<StorageResult>;
+  finish: (kind: CatalogKind, sourceId: string, syncId: number) => Promise<StorageResult<number>>;
+  deleteSource: (sourceId: string) => Promise<StorageResult>;
+  getStats: () => Promise<StorageResult<CatalogStats>>;
+  // Called after every write to the catalog; returns an unsubscribe function
+  onChanged: (callback: () => void) => () => void;
+}
+
+export interface SyncDaemonApi {
+  // Ask the main process to (re)connect this window to the sync daemon. Each
+  // side receives its end of a MessagePort as a window message { type: 'sync-daemon-port' }.
+  connect: (role: 'daemon' | 'ui') => void;
 }
 
 export interface PlatformApi {
@@ -108,6 +244,8 @@ declare global {
     electronWindow?: ElectronWindowApi;
     storage?: StorageApi;
     fetchProxy?: FetchProxyApi;
+    syncDaemon?: SyncDaemonApi;
+    catalog?: CatalogApi;
     platform?: PlatformApi;
   }
 }
@@ -0,0 +1,24 @@
+/**
+ * Message protocol between the renderer and the EPG worker
+ */
+
+import type { Source } from '@sbtltv/core';
+import type { EpgIngestResult, EpgProgress, EpgSyncOptions } from '../db/epg-ingest';
+import type { FetchProxyApi } from '../types/electron';
+
+type FetchMethod = keyof FetchProxyApi;
+
+// Renderer → worker
+export type EpgWorkerRequest =
+  | { type: 'sync'; jobId: number; source: Source; options: EpgSyncOptions; proxied: boolean }
+  | { type: 'cancel'; jobId: number }
+  | { type: 'fetch-result'; requestId: number; result: Awaited<ReturnType<FetchProxyApi[FetchMethod]>> }
+  // Body port of a relayed fetchStream (picked up by waitForStreamPort in the worker)
+  | { type: 'fetch-stream-port'; streamId: string };
+
+// Worker → renderer
+export type EpgWorkerEvent =
+  | { type: 'progress'; jobId: number; progress: EpgProgress }
+  | { type: 'done'; jobId: number; result: EpgIngestResult }
+  | { type: 'error'; jobId: number; error: string }
+  | { type: 'fetch'; requestId: number; method: FetchMethod; args: unknown[] };
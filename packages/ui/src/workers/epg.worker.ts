@@ -0,0 +1,91 @@
+/**
+ * EPG Worker
+ *
+ * Runs the complete EPG pipeline (fetch → parse → map → IndexedDB write) off
+ * the renderer thread. Opens the same Dexie database as the UI; liveQuery
+ * subscribers in the renderer are notified of the writes automatically.
+ *
+ * The preload bridge (window.fetchProxy) only exists in the renderer, so
+ * network requests are relayed back to it over postMessage.
+ */
+
+import { ingestEpg, type EpgProgress } from '../db/epg-ingest';
+import type { FetchProxyApi } from '../types/electron';
+import type { EpgWorkerEvent, EpgWorkerRequest } from './epg-protocol';
+
+// Minimum interval between progress events (keeps renderer re-renders cheap)
+const PROGRESS_INTERVAL_MS = 250;
+
+const jobs = new Map<number, AbortController>();
+const pendingFetches = new Map<number, (result: unknown) => void>();
+let fetchRequestId = 0;
+
+function post(event: EpgWorkerEvent): void {
+  self.postMessage(event);
+}
+
+function relay(method: keyof FetchProxyApi) {
+  return (...args: unknown[]) =>
+    new Promise<never>((resolve) => {
+      const requestId = ++fetchRequestId;
+      pendingFetches.set(requestId, resolve as (result: unknown) => void);
+      post({ type: 'fetch', requestId, method, args });
+    });
+}
+
+function installFetchRelay(): void {
+  if (self.fetchProxy) return;
+  self.fetchProxy = {
+    fetch: relay('fetch'),
+    fetchJsonArray: relay('fetchJsonArray'),
+    fetchStream: relay('fetchStream'),
+    getStats: relay('getStats'),
+    getCacheStats: relay('getCacheStats'),
+  };
+}
+
+async function runSync(jobId: number, request: Extract<EpgWorkerRequest, { type: 'sync' }>): Promise<void> {
+  const controller = new AbortController();
+  jobs.set(jobId, controller);
+
+  if (request.proxied) {
+    installFetchRelay();
+  }
+
+  let lastProgress = 0;
+  const onProgress = (progress: EpgProgress) => {
+    const now = Date.now();
+    if (now - lastProgress < PROGRESS_INTERVAL_MS) return;
+    lastProgress = now;
+    post({ type: 'progress', jobId, progress });
+  };
+
+  try {
+    const result = await ingestEpg(request.source, request.options, onProgress, controller.signal);
+    post({ type: 'done', jobId, result });
+  } catch (err) {
+    post({ type: 'error', jobId, error: err instanceof Error ? err.message : 'EPG sync failed' });
+  } finally {
+    jobs.delete(jobId);
+  }
+}
+
+self.addEventListener('message', (event: MessageEvent<EpgWorkerRequest>) => {
+  const request = event.data;
+  switch (request.type) {
+    case 'sync':
+      runSync(request.jobId, request);
+      break;
+    case 'cancel':
+      jobs.get(request.jobId)?.abort();
+      break;
+    case 'fetch-result': {
+      const resolve = pendingFetches.get(request.requestId);
+      if (resolve) {
+        pendingFetches.delete(request.requestId);
+        resolve(request.result);
+      }
+      break;
+    }
+  }
+});
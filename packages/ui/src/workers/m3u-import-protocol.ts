@@ -0,0 +1,18 @@
+/**
+ * Message protocol between the renderer and the M3U import worker
+ */
+
+import type { M3UImportSummary } from '../db/m3u-import';
+
+// Renderer → worker (the file port is transferred with 'parse')
+export type M3UImportWorkerRequest =
+  | { type: 'parse'; importId: string; sourceId: string; port: MessagePort }
+  | { type: 'commit'; importId: string }
+  | { type: 'discard'; importId: string };
+
+// Worker → renderer
+export type M3UImportWorkerEvent =
+  | { type: 'progress'; importId: string; bytes: number; channels: number }
+  | { type: 'parsed'; importId: string; summary: M3UImportSummary }
+  | { type: 'committed'; importId: string; summary: M3UImportSummary }
+  | { type: 'error'; importId: string; error: string };
@@ -0,0 +1,129 @@
+/**
+ * M3U Import Worker
+ *
+ * Parses a playlist picked from disk while the main process streams it over
+ * a MessagePort, so neither the main process nor the UI thread ever holds or
+ * scans the file as one string. Parsed batches stay here until the user
+ * saves the source ('commit' writes them to IndexedDB) or cancels
+ * ('discard'), so saving doesn't parse the file a second time.
+ */
+
+import { M3UStreamParser, DEFAULT_M3U_BATCH_SIZE, type M3UBatch } from '@sbtltv/local-adapter';
+import { db } from '../db';
+import type { M3UImportSummary } from '../db/m3u-import';
+import type { M3UFileStreamMessage } from '../types/electron';
+import type { M3UImportWorkerEvent, M3UImportWorkerRequest } from './m3u-import-protocol';
+
+// Minimum interval between progress events
+const PROGRESS_INTERVAL_MS = 250;
+
+interface ParsedImport {
+  sourceId: string;
+  batches: M3UBatch[];
+  summary: M3UImportSummary;
+}
+
+const imports = new Map<string, ParsedImport>();
+
+function post(event: M3UImportWorkerEvent): void {
+  self.postMessage(event);
+}
+
+function parse(importId: string, sourceId: string, port: MessagePort): void {
+  const parser = new M3UStreamParser(sourceId);
+  const decoder = new TextDecoder();
+  const batches: M3UBatch[] = [];
+  let bytes = 0;
+  let categories = 0;
+  let lastProgress = 0;
+
+  const collect = (batch: M3UBatch) => {
+    categories += batch.categories.length;
+    batches.push(batch);
+  };
+
+  port.onmessage = (event: MessageEvent<M3UFileStreamMessage>) => {
+    const message = event.data;
+    switch (message.type) {
+      case 'chunk': {
+        bytes += message.data.byteLength;
+        parser.push(decoder.decode(message.data, { stream: true }));
+        port.postMessage({ type: 'ack' });
+        while (parser.pendingCount >= DEFAULT_M3U_BATCH_SIZE) {
+          collect(parser.drain(DEFAULT_M3U_BATCH_SIZE));
+        }
+
+        const now = Date.now();
+        if (now - lastProgress >= PROGRESS_INTERVAL_MS) {
+          lastProgress = now;
+          post({ type: 'progress', importId, bytes, channels: parser.count });
+        }
+        break;
+      }
+      case 'end': {
+        parser.push(decoder.decode());
+        collect(parser.end());
+        port.close();
+        const summary: M3UImportSummary = {
+          channelCount: parser.count,
+          categoryCount: categories,
+          epgUrl: parser.epgUrl,
+        };
+        imports.set(importId, { sourceId, batches, summary });
+        post({ type: 'parsed', importId, summary });
+        break;
+      }
+      case 'error':
+        port.close();
+        post({ type: 'error', importId, error: message.error });
+        break;
+    }
+  };
+}
+
+async function commit(importId: string): Promise<void> {
+  const parsed = imports.get(importId);
+  if (!parsed) {
+    post({ type: 'error', importId, error: 'Import not found' });
+    return;
+  }
+  imports.delete(importId);
+
+  try {
+    for (const batch of parsed.batches) {
+      await db.transaction('rw', [db.channels, db.categories], async () => {
+        if (batch.channels.length > 0) {
+          await db.channels.bulkPut(batch.channels);
+        }
+        if (batch.categories.length > 0) {
+          await db.categories.bulkPut(batch.categories);
+        }
+      });
+    }
+    await db.sourcesMeta.put({
+      source_id: parsed.sourceId,
+      epg_url: parsed.summary.epgUrl ?? undefined,
+      last_synced: new Date(),
+      channel_count: parsed.summary.channelCount,
+      category_count: parsed.summary.categoryCount,
+    });
+    post({ type: 'committed', importId, summary: parsed.summary });
+  } catch (err) {
+    post({ type: 'error', importId, error: err instanceof Error ? err.message : 'Failed to store playlist' });
+  }
+}
+
+self.addEventListener('message', (event: MessageEvent<M3UImportWorkerRequest>) => {
+  const request = event.data;
+  switch (request.type) {
+    case 'parse':
+      parse(request.importId, request.sourceId, request.port);
+      break;
+    case 'commit':
+      commit(request.importId);
+      break;
+    case 'discard':
+      imports.delete(request.importId);
+      break;
+  }
+});
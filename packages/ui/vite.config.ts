@@ -8,6 +8,10 @@ export default defineConfig({
     outDir: 'dist',
     emptyOutDir: true,
   },
+  worker: {
+    // EPG worker imports Dexie + local-adapter, needs ES module output
+    format: 'es',
+  },
   esbuild: {
     // Strip console.* and debugger in production builds
     drop: process.env.NODE_ENV === 'production' ? ['console', 'debugger'] : [],